@@ -3,53 +3,123 @@
 in vec3 vNormal;
 in vec3 vWorldPos;
 in vec2 vUV;
-in vec4 vLightSpacePos;
+in float vViewDepth;
+in vec3 vTint;
 
 out vec4 FragColor;
 
-uniform vec3 uViewPos;
+// per-frame data, shared with every program through uniform buffers
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProj;
+    vec4 uViewPos;   // xyz = camera position
+};
+layout(std140) uniform LightData {
+    mat4 uCascadeVP[4];    // light view-projection of each shadow cascade
+    vec4 uCascadeSplits;   // view distance where each cascade ends
+    vec4 uLightDir;        // xyz = direction the light travels (unit)
+    vec4 uLightColor;      // rgb = color, a = intensity
+    ivec4 uShadowParams;   // x = cascade count
+};
+
 uniform vec3 uMatDiffuse;
 uniform bool uHasDiffuse;
 uniform bool uUseAlphaTest;
 uniform float uAlphaCutoff;
 uniform sampler2D uDiffuseMap;
 
-uniform vec3 uLightDir;        // direction FROM surface toward light (unit)
-uniform vec3 uLightColor;
-uniform float uLightIntensity;
+uniform sampler2DShadow uShadowMaps[4]; // one depth map per cascade, hardware compare
+
+// filter taps per fragment, chosen by the shadow quality preset: 1, 4, 8 or 16
+#ifndef SHADOW_TAPS
+#define SHADOW_TAPS 4
+#endif
+// radius of the Poisson taps, in shadow map texels
+#define SHADOW_FILTER_RADIUS 1.5
+
+#if SHADOW_TAPS == 8
+const vec2 kPoisson[8] = vec2[](
+    vec2(-0.326212, -0.405805), vec2(-0.840144, -0.073580),
+    vec2(-0.695914,  0.457137), vec2(-0.203345,  0.620716),
+    vec2( 0.962340, -0.194983), vec2( 0.473434, -0.480026),
+    vec2( 0.519456,  0.767022), vec2( 0.185461, -0.893124));
+#elif SHADOW_TAPS == 16
+const vec2 kPoisson[16] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2( 0.34495938,  0.29387760),
+    vec2(-0.91588581,  0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543,  0.27676845), vec2( 0.97484398,  0.75648379),
+    vec2( 0.44323325, -0.97511554), vec2( 0.53742981, -0.47373420),
+    vec2(-0.26496911, -0.41893023), vec2( 0.79197514,  0.19090188),
+    vec2(-0.24188840,  0.99706507), vec2(-0.81409955,  0.91437590),
+    vec2( 0.19984126,  0.78641367), vec2( 0.14383161, -0.14100790));
+#endif
+
+float SampleShadowMap(sampler2DShadow shadowMap, vec3 projCoords, float bias)
+{
+    // outside shadow map: no shadow
+    if (projCoords.x < 0.0 || projCoords.x > 1.0 || projCoords.y < 0.0 || projCoords.y > 1.0)
+        return 0.0;
 
-uniform sampler2D uShadowMap;
+    // every texture() call returns the lit fraction of a bilinear 2x2 compare
+    float ref = projCoords.z - bias;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0));
+    float lit = 0.0;
+#if SHADOW_TAPS == 1
+    lit = texture(shadowMap, vec3(projCoords.xy, ref));
+#elif SHADOW_TAPS == 4
+    // half-texel offsets: together the taps cover a 3x3 texel tent
+    for (int x = 0; x < 2; ++x)
+    {
+        for (int y = 0; y < 2; ++y)
+        {
+            vec2 offset = vec2(float(x) - 0.5, float(y) - 0.5) * texelSize;
+            lit += texture(shadowMap, vec3(projCoords.xy + offset, ref));
+        }
+    }
+    lit *= 0.25;
+#else
+    // rotate the disk per pixel so the tap pattern turns into noise instead of banding
+    float angle = 6.2831853 * fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+    mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+    for (int i = 0; i < SHADOW_TAPS; ++i)
+    {
+        vec2 offset = rotation * kPoisson[i] * SHADOW_FILTER_RADIUS * texelSize;
+        lit += texture(shadowMap, vec3(projCoords.xy + offset, ref));
+    }
+    lit /= float(SHADOW_TAPS);
+#endif
+
+    return 1.0 - lit;
+}
 
-float ShadowCalculation(vec4 lightSpacePos, vec3 normal, vec3 lightDir)
+float ShadowCalculation(vec3 worldPos, float viewDepth, vec3 normal, vec3 lightDir)
 {
+    // first cascade whose slice reaches this fragment; beyond the last one: no shadow
+    int count = uShadowParams.x;
+    int cascade = 0;
+    while (cascade < count && viewDepth > uCascadeSplits[cascade])
+        ++cascade;
+    if (cascade >= count)
+        return 0.0;
+
+    vec4 lightSpacePos = uCascadeVP[cascade] * vec4(worldPos, 1.0);
     // perspective divide -> NDC
     vec3 projCoords = lightSpacePos.xyz / lightSpacePos.w;
     // NDC -> [0,1]
     projCoords = projCoords * 0.5 + 0.5;
 
-    // outside shadow map: no shadow
-    if (projCoords.x < 0.0 || projCoords.x > 1.0 || projCoords.y < 0.0 || projCoords.y > 1.0)
-        return 0.0;
-
-    float currentDepth = projCoords.z;
-
     // better bias: smaller base and normal-dependent
     float bias = max(0.0005 * (1.0 - dot(normal, lightDir)), 0.00005);
 
-    // PCF 3x3
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / vec2(textureSize(uShadowMap, 0));
-    for (int x = -1; x <= 1; ++x)
-    {
-        for (int y = -1; y <= 1; ++y)
-        {
-            float pcfDepth = texture(uShadowMap, projCoords.xy + vec2(x,y) * texelSize).r;
-            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-        }
-    }
-    shadow /= 9.0;
-
-    return clamp(shadow, 0.0, 1.0);
+    // samplers in an array may only be indexed by constants in GLSL 3.30
+    if (cascade == 0)
+        return SampleShadowMap(uShadowMaps[0], projCoords, bias);
+    if (cascade == 1)
+        return SampleShadowMap(uShadowMaps[1], projCoords, bias);
+    if (cascade == 2)
+        return SampleShadowMap(uShadowMaps[2], projCoords, bias);
+    return SampleShadowMap(uShadowMaps[3], projCoords, bias);
 }
 
 void main()
@@ -62,25 +132,27 @@ void main()
         baseColor = t.rgb;
         alpha = t.a;
     }
+    baseColor *= vTint;
     if (uUseAlphaTest && alpha < uAlphaCutoff) discard;
 
     vec3 N = normalize(vNormal);
-    vec3 L = normalize(-uLightDir); // we use uLightDir as direction FROM fragment to light
-    vec3 V = normalize(uViewPos - vWorldPos);
+    vec3 L = normalize(-uLightDir.xyz); // we use uLightDir as direction FROM fragment to light
+    vec3 V = normalize(uViewPos.xyz - vWorldPos);
     vec3 H = normalize(L + V);
 
     float diff = max(dot(N, L), 0.0);
     float spec = pow(max(dot(N, H), 0.0), 32.0);
 
     // reduce ambient so that shadows & diffuse are visible
-    vec3 ambient = 0.06 * baseColor * uLightColor;
-    vec3 diffuse = diff * baseColor * uLightColor;
-    vec3 specular = spec * vec3(1.0) * uLightColor * 0.5;
+    vec3 lightColor = uLightColor.rgb;
+    vec3 ambient = 0.06 * baseColor * lightColor;
+    vec3 diffuse = diff * baseColor * lightColor;
+    vec3 specular = spec * vec3(1.0) * lightColor * 0.5;
 
-    // shadow from depth map (vLightSpacePos must be provided by vertex shader)
-    float shadow = ShadowCalculation(vLightSpacePos, N, L);
+    // shadow from the cascade covering this fragment
+    float shadow = ShadowCalculation(vWorldPos, vViewDepth, N, L);
 
-    vec3 color = ambient + (1.0 - shadow) * (diffuse + specular) * uLightIntensity;
+    vec3 color = ambient + (1.0 - shadow) * (diffuse + specular) * uLightColor.a;
 
     // simple gamma
     color = pow(color, vec3(1.0/2.2));
@@ -1,26 +1,80 @@
 #version 330 core
+// vertex layout chosen at load (VertexFormat): 0 = float normals, 1 = octahedral (2 x int16),
+// 2 = 10:10:10 ints. Positions may be int16 relative to the mesh bounds, UVs half floats.
+#ifndef NORMAL_ENCODING
+#define NORMAL_ENCODING 0
+#endif
+
 layout(location = 0) in vec3 aPos;
+#if NORMAL_ENCODING == 1
+layout(location = 1) in vec2 aNormal;
+#elif NORMAL_ENCODING == 2
+layout(location = 1) in vec4 aNormal;
+#else
 layout(location = 1) in vec3 aNormal;
+#endif
 layout(location = 2) in vec2 aUV;
+// per-instance attributes (only read when uInstanced is set)
+layout(location = 3) in mat4 aInstanceModel;
+layout(location = 7) in vec3 aInstanceColor;
 
 out vec3 vNormal;
 out vec3 vWorldPos;
 out vec2 vUV;
-out vec4 vLightSpacePos;
+out float vViewDepth;
+out vec3 vTint;
+
+// per-frame data, shared with every program through uniform buffers
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProj;
+    vec4 uViewPos;   // xyz = camera position
+};
+layout(std140) uniform LightData {
+    mat4 uCascadeVP[4];    // light view-projection of each shadow cascade
+    vec4 uCascadeSplits;   // view distance where each cascade ends
+    vec4 uLightDir;        // xyz = direction the light travels (unit)
+    vec4 uLightColor;      // rgb = color, a = intensity
+    ivec4 uShadowParams;   // x = cascade count
+};
 
+// decodes aPos to model space: aPos * uPosScale + uPosOffset
+uniform vec3 uPosScale;
+uniform vec3 uPosOffset;
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
 uniform mat3 uNormalMat;
-uniform mat4 uLightVP;
+uniform bool uInstanced;
+
+vec3 DecodeNormal()
+{
+#if NORMAL_ENCODING == 1
+    // unfold the octahedron
+    vec2 e = aNormal / 32767.0;
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+#elif NORMAL_ENCODING == 2
+    return normalize(aNormal.xyz / 511.0);
+#else
+    return aNormal;
+#endif
+}
 
 void main() {
-    vec4 world = uModel * vec4(aPos,1.0);
+    mat4 model = uInstanced ? aInstanceModel : uModel;
+    // instances use uniform scale, so the upper 3x3 is a valid normal matrix once normalized
+    mat3 normalMat = uInstanced ? mat3(aInstanceModel) : uNormalMat;
+
+    vec3 pos = aPos * uPosScale + uPosOffset;
+    vec4 world = model * vec4(pos,1.0);
     vWorldPos = world.xyz;
 
-    vNormal = normalize(uNormalMat * aNormal);
+    vNormal = normalize(normalMat * DecodeNormal());
     vUV = aUV;
+    vTint = uInstanced ? aInstanceColor : vec3(1.0);
     
-    vLightSpacePos = uLightVP * world;
-    gl_Position = uProj * uView * world;
+    vec4 viewPos = uView * world;
+    vViewDepth = -viewPos.z; // picks the shadow cascade
+    gl_Position = uProj * viewPos;
 }
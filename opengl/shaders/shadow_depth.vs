@@ -1,10 +1,25 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
+layout (location = 0) in vec3 aPos;   // position-only stream, maybe 16-bit quantized
+layout (location = 3) in mat4 aInstanceModel;
 
-uniform mat4 uLightVP;
+layout(std140) uniform LightData {
+    mat4 uCascadeVP[4];    // light view-projection of each shadow cascade
+    vec4 uCascadeSplits;   // view distance where each cascade ends
+    vec4 uLightDir;        // xyz = direction the light travels (unit)
+    vec4 uLightColor;      // rgb = color, a = intensity
+    ivec4 uShadowParams;   // x = cascade count
+};
+
+// decodes aPos to model space: aPos * uPosScale + uPosOffset
+uniform vec3 uPosScale;
+uniform vec3 uPosOffset;
 uniform mat4 uModel;
+uniform int uCascade;   // cascade being rendered
+uniform bool uInstanced;
 
 void main()
 {
-    gl_Position = uLightVP * uModel * vec4(aPos, 1.0);
+    mat4 model = uInstanced ? aInstanceModel : uModel;
+    vec3 pos = aPos * uPosScale + uPosOffset;
+    gl_Position = uCascadeVP[uCascade] * model * vec4(pos, 1.0);
 }
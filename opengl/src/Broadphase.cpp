@@ -0,0 +1,804 @@
+// src/Broadphase.cpp
+#include "Broadphase.h"
+#include <algorithm>
+#include <cmath>
+
+const char *BroadphaseName(BroadphaseType type)
+{
+    switch (type)
+    {
+    case BroadphaseType::BruteForce:
+        return "brute force";
+    case BroadphaseType::SweepAndPrune:
+        return "sweep and prune";
+    case BroadphaseType::UniformGrid:
+        return "uniform grid";
+    case BroadphaseType::AABBTree:
+        return "aabb tree";
+    }
+    return "?";
+}
+
+static glm::vec3 SafeInverse(const glm::vec3 &d)
+{
+    // 1/0 gives +-inf, which RayAABB handles
+    return glm::vec3(1.0f / d.x, 1.0f / d.y, 1.0f / d.z);
+}
+
+// Tight boxes indexed by proxy id, shared by all implementations. Pairs and queries are always
+// confirmed against these, so every broadphase reports exactly the same sets.
+class ProxyTable
+{
+public:
+    void Set(ProxyId id, const AABB &box)
+    {
+        if (id >= boxes.size())
+        {
+            boxes.resize(id + 1);
+            used.resize(id + 1, 0);
+        }
+        boxes[id] = box;
+        used[id] = 1;
+    }
+    void Unset(ProxyId id)
+    {
+        if (id < used.size())
+            used[id] = 0;
+    }
+    void Clear()
+    {
+        boxes.clear();
+        used.clear();
+    }
+    bool Has(ProxyId id) const { return id < used.size() && used[id]; }
+    void Reserve(size_t n)
+    {
+        boxes.reserve(n);
+        used.reserve(n);
+    }
+
+    std::vector<AABB> boxes;
+    std::vector<uint8_t> used;
+};
+
+// ===== Brute force =====
+class BruteForceBroadphase : public Broadphase
+{
+public:
+    void Insert(ProxyId id, const AABB &box) override
+    {
+        if (!table.Has(id))
+        {
+            slot.resize(std::max<size_t>(slot.size(), id + 1));
+            slot[id] = (uint32_t)ids.size();
+            ids.push_back(id);
+        }
+        table.Set(id, box);
+    }
+    void Update(ProxyId id, const AABB &box) override { table.boxes[id] = box; }
+    void Remove(ProxyId id) override
+    {
+        if (!table.Has(id))
+            return;
+        // swap-remove from the dense list
+        uint32_t s = slot[id];
+        ids[s] = ids.back();
+        slot[ids[s]] = s;
+        ids.pop_back();
+        table.Unset(id);
+    }
+    void Clear() override
+    {
+        table.Clear();
+        ids.clear();
+    }
+
+    void FindPairs(std::vector<ProxyPair> &out) override
+    {
+        out.clear();
+        for (size_t i = 0; i < ids.size(); ++i)
+            for (size_t j = i + 1; j < ids.size(); ++j)
+                if (AABBOverlap(table.boxes[ids[i]], table.boxes[ids[j]]))
+                    out.push_back(std::minmax(ids[i], ids[j]));
+    }
+    void QueryAABB(const AABB &box, std::vector<ProxyId> &out) override
+    {
+        for (ProxyId id : ids)
+            if (AABBOverlap(box, table.boxes[id]))
+                out.push_back(id);
+    }
+    void QueryRay(const glm::vec3 &origin, const glm::vec3 &dir, float maxT, std::vector<ProxyId> &out) override
+    {
+        glm::vec3 inv = SafeInverse(dir);
+        float t;
+        for (ProxyId id : ids)
+            if (RayAABB(origin, inv, table.boxes[id], maxT, t))
+                out.push_back(id);
+    }
+
+private:
+    ProxyTable table;
+    std::vector<ProxyId> ids;   // dense list of live proxies
+    std::vector<uint32_t> slot; // proxy id -> index in ids
+};
+
+// ===== Sweep and prune (single axis) =====
+class SweepAndPruneBroadphase : public Broadphase
+{
+public:
+    void Insert(ProxyId id, const AABB &box) override
+    {
+        if (id >= listed.size())
+            listed.resize(id + 1, 0);
+        // an id removed and re-inserted before the next Sort still has its entry
+        if (!listed[id])
+        {
+            order.push_back({box.min.x, id});
+            ++appended;
+        }
+        listed[id] = 1;
+        table.Set(id, box);
+    }
+    void Update(ProxyId id, const AABB &box) override { table.boxes[id] = box; }
+    void Remove(ProxyId id) override
+    {
+        // dead entries are dropped at the next Sort
+        table.Unset(id);
+        removed = true;
+    }
+    void Clear() override
+    {
+        table.Clear();
+        order.clear();
+        listed.clear();
+        appended = 0;
+        removed = false;
+    }
+
+    void FindPairs(std::vector<ProxyPair> &out) override
+    {
+        out.clear();
+        Sort();
+        const size_t n = order.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            const AABB &a = table.boxes[order[i].id];
+            for (size_t j = i + 1; j < n && order[j].minX <= a.max.x; ++j)
+            {
+                const AABB &b = table.boxes[order[j].id];
+                if (a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z)
+                    out.push_back(std::minmax(order[i].id, order[j].id));
+            }
+        }
+    }
+    void QueryAABB(const AABB &box, std::vector<ProxyId> &out) override
+    {
+        Sort();
+        // nothing that starts more than maxWidth before box.min.x can reach it
+        auto first = std::lower_bound(order.begin(), order.end(), box.min.x - maxWidth,
+                                      [](const Entry &e, float x)
+                                      { return e.minX < x; });
+        for (auto it = first; it != order.end() && it->minX <= box.max.x; ++it)
+            if (AABBOverlap(box, table.boxes[it->id]))
+                out.push_back(it->id);
+    }
+    void QueryRay(const glm::vec3 &origin, const glm::vec3 &dir, float maxT, std::vector<ProxyId> &out) override
+    {
+        // the ray's x extent is the only thing the sorted axis can cull by
+        Sort();
+        float x0 = origin.x, x1 = origin.x + dir.x * maxT;
+        if (x0 > x1)
+            std::swap(x0, x1);
+        glm::vec3 inv = SafeInverse(dir);
+        float t;
+        auto first = std::lower_bound(order.begin(), order.end(), x0 - maxWidth,
+                                      [](const Entry &e, float x)
+                                      { return e.minX < x; });
+        for (auto it = first; it != order.end() && it->minX <= x1; ++it)
+            if (RayAABB(origin, inv, table.boxes[it->id], maxT, t))
+                out.push_back(it->id);
+    }
+
+private:
+    struct Entry
+    {
+        float minX; // copy of boxes[id].min.x so the sweep stays in one array
+        ProxyId id;
+    };
+
+    // Refresh keys and insertion-sort: bodies move a little per frame, so the list is almost
+    // sorted and this is close to linear. Entries appended since the last sort are in no
+    // particular order, so they are sorted separately and merged in.
+    void Sort()
+    {
+        if (removed)
+        {
+            order.erase(std::remove_if(order.begin(), order.end(), [&](const Entry &e)
+                                       { return !(listed[e.id] = table.Has(e.id)); }),
+                        order.end());
+            removed = false;
+        }
+        maxWidth = 0.0f;
+        for (Entry &e : order)
+        {
+            const AABB &b = table.boxes[e.id];
+            e.minX = b.min.x;
+            maxWidth = std::max(maxWidth, b.max.x - b.min.x);
+        }
+        const size_t settled = order.size() - std::min(appended, order.size());
+        for (size_t i = 1; i < settled; ++i)
+        {
+            Entry e = order[i];
+            size_t j = i;
+            for (; j > 0 && order[j - 1].minX > e.minX; --j)
+                order[j] = order[j - 1];
+            order[j] = e;
+        }
+        if (appended > 0)
+        {
+            auto byMinX = [](const Entry &a, const Entry &b)
+            { return a.minX < b.minX; };
+            std::sort(order.begin() + settled, order.end(), byMinX);
+            std::inplace_merge(order.begin(), order.begin() + settled, order.end(), byMinX);
+            appended = 0;
+        }
+    }
+
+    ProxyTable table;
+    std::vector<Entry> order;
+    std::vector<uint8_t> listed; // proxy id has an entry in order
+    size_t appended = 0;         // entries pushed since the last Sort (at the back of order)
+    float maxWidth = 0.0f;
+    bool removed = false;
+};
+
+// ===== Uniform grid (hashed) =====
+// Cells are identified by packed integer coordinates; the cell lists are rebuilt lazily into
+// one sorted array of (cell, proxy) entries, so there is no per-cell allocation.
+class UniformGridBroadphase : public Broadphase
+{
+public:
+    explicit UniformGridBroadphase(float cellSize)
+        : cell(cellSize > 0.0f ? cellSize : 1.0f), invCell(1.0f / cell) {}
+
+    void Insert(ProxyId id, const AABB &box) override
+    {
+        table.Set(id, box);
+        dirty = true;
+    }
+    void Update(ProxyId id, const AABB &box) override
+    {
+        table.boxes[id] = box;
+        dirty = true;
+    }
+    void Remove(ProxyId id) override
+    {
+        if (!table.Has(id))
+            return;
+        table.Unset(id);
+        dirty = true;
+    }
+    void Clear() override
+    {
+        table.Clear();
+        entries.clear();
+        dirty = false;
+    }
+
+    void FindPairs(std::vector<ProxyPair> &out) override
+    {
+        out.clear();
+        Rebuild();
+        for (size_t start = 0; start < entries.size();)
+        {
+            size_t end = start + 1;
+            while (end < entries.size() && entries[end].key == entries[start].key)
+                ++end;
+            for (size_t i = start; i < end; ++i)
+                for (size_t j = i + 1; j < end; ++j)
+                {
+                    ProxyId a = entries[i].id, b = entries[j].id;
+                    const AABB &ba = table.boxes[a], &bb = table.boxes[b];
+                    if (!AABBOverlap(ba, bb))
+                        continue;
+                    // a pair sharing several cells is reported only from the cell holding the
+                    // min corner of the intersection
+                    if (Key(CellOf(glm::max(ba.min, bb.min))) == entries[start].key)
+                        out.push_back(std::minmax(a, b));
+                }
+            start = end;
+        }
+    }
+    void QueryAABB(const AABB &box, std::vector<ProxyId> &out) override
+    {
+        Rebuild();
+        NextStamp();
+        glm::ivec3 lo = CellOf(box.min), hi = CellOf(box.max);
+        for (int x = lo.x; x <= hi.x; ++x)
+            for (int y = lo.y; y <= hi.y; ++y)
+                for (int z = lo.z; z <= hi.z; ++z)
+                    VisitCell(Key(glm::ivec3(x, y, z)), [&](ProxyId id)
+                              {
+                                  if (AABBOverlap(box, table.boxes[id]))
+                                      out.push_back(id); });
+    }
+    void QueryRay(const glm::vec3 &origin, const glm::vec3 &dir, float maxT, std::vector<ProxyId> &out) override
+    {
+        Rebuild();
+        if (entries.empty())
+            return;
+        NextStamp();
+        glm::vec3 inv = SafeInverse(dir);
+
+        // clip the ray to the occupied region so the walk never leaves it
+        float tEnter, tExit;
+        if (!RayAABB(origin, inv, bounds, maxT, tEnter))
+            return;
+        glm::vec3 back = origin + dir * maxT;
+        if (!RayAABB(back, -inv, bounds, maxT, tExit))
+            tExit = 0.0f;
+        tExit = maxT - tExit;
+
+        // 3D DDA (Amanatides & Woo) from the entry point
+        glm::vec3 p = origin + dir * tEnter;
+        glm::ivec3 c = glm::clamp(CellOf(p), CellOf(bounds.min), CellOf(bounds.max));
+        glm::ivec3 step;
+        glm::vec3 tNext, tDelta;
+        for (int k = 0; k < 3; ++k)
+        {
+            step[k] = (dir[k] > 0.0f) ? 1 : (dir[k] < 0.0f ? -1 : 0);
+            float boundary = (float)(c[k] + (step[k] > 0 ? 1 : 0)) * cell;
+            tNext[k] = step[k] ? tEnter + (boundary - p[k]) * inv[k] : INFINITY;
+            tDelta[k] = step[k] ? cell * std::fabs(inv[k]) : INFINITY;
+        }
+
+        float t;
+        while (true)
+        {
+            VisitCell(Key(c), [&](ProxyId id)
+                      {
+                          if (RayAABB(origin, inv, table.boxes[id], maxT, t))
+                              out.push_back(id); });
+            int k = (tNext.x < tNext.y) ? (tNext.x < tNext.z ? 0 : 2) : (tNext.y < tNext.z ? 1 : 2);
+            if (tNext[k] > tExit)
+                break;
+            c[k] += step[k];
+            tNext[k] += tDelta[k];
+        }
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        ProxyId id;
+        bool operator<(const Entry &o) const { return key < o.key || (key == o.key && id < o.id); }
+    };
+
+    glm::ivec3 CellOf(const glm::vec3 &p) const
+    {
+        return glm::ivec3((int)std::floor(p.x * invCell), (int)std::floor(p.y * invCell), (int)std::floor(p.z * invCell));
+    }
+    // 21 bits per axis; far-apart cells may alias, which only costs extra AABB tests
+    static uint64_t Key(const glm::ivec3 &c)
+    {
+        const uint64_t mask = (1u << 21) - 1;
+        return (((uint64_t)c.x & mask) << 42) | (((uint64_t)c.y & mask) << 21) | ((uint64_t)c.z & mask);
+    }
+
+    void Rebuild()
+    {
+        if (!dirty)
+            return;
+        dirty = false;
+        entries.clear();
+        bool first = true;
+        for (ProxyId id = 0; id < table.boxes.size(); ++id)
+        {
+            if (!table.used[id])
+                continue;
+            const AABB &b = table.boxes[id];
+            bounds = first ? b : AABBUnion(bounds, b);
+            first = false;
+            glm::ivec3 lo = CellOf(b.min), hi = CellOf(b.max);
+            for (int x = lo.x; x <= hi.x; ++x)
+                for (int y = lo.y; y <= hi.y; ++y)
+                    for (int z = lo.z; z <= hi.z; ++z)
+                        entries.push_back({Key(glm::ivec3(x, y, z)), id});
+        }
+        std::sort(entries.begin(), entries.end());
+        if (stamp.size() < table.boxes.size())
+            stamp.resize(table.boxes.size(), 0);
+    }
+
+    void NextStamp()
+    {
+        if (++currentStamp == 0)
+        {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            currentStamp = 1;
+        }
+    }
+
+    // calls fn once per query for every proxy in the cell (stamps skip proxies already seen)
+    template <typename Fn>
+    void VisitCell(uint64_t key, Fn fn)
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), Entry{key, 0});
+        for (; it != entries.end() && it->key == key; ++it)
+        {
+            if (stamp[it->id] == currentStamp)
+                continue;
+            stamp[it->id] = currentStamp;
+            fn(it->id);
+        }
+    }
+
+    float cell, invCell;
+    ProxyTable table;
+    std::vector<Entry> entries;
+    std::vector<uint32_t> stamp;
+    uint32_t currentStamp = 0;
+    AABB bounds; // union of all boxes at the last rebuild
+    bool dirty = false;
+};
+
+// ===== Dynamic AABB tree =====
+// Leaves hold boxes fattened by a margin so small motions don't touch the tree; insertion
+// picks the sibling by surface-area cost and rotations keep the tree balanced (as in Box2D).
+class AABBTreeBroadphase : public Broadphase
+{
+public:
+    void Insert(ProxyId id, const AABB &box) override
+    {
+        if (table.Has(id))
+        {
+            Update(id, box);
+            return;
+        }
+        table.Set(id, box);
+        if (id >= leafOf.size())
+            leafOf.resize(id + 1, NIL);
+        int leaf = AllocateNode();
+        nodes[leaf].box = Fatten(box);
+        nodes[leaf].id = id;
+        InsertLeaf(leaf);
+        leafOf[id] = leaf;
+    }
+    void Update(ProxyId id, const AABB &box) override
+    {
+        table.boxes[id] = box;
+        int leaf = leafOf[id];
+        const AABB &fat = nodes[leaf].box;
+        if (glm::all(glm::lessThanEqual(fat.min, box.min)) && glm::all(glm::lessThanEqual(box.max, fat.max)))
+            return;
+        RemoveLeaf(leaf);
+        nodes[leaf].box = Fatten(box);
+        InsertLeaf(leaf);
+    }
+    void Remove(ProxyId id) override
+    {
+        if (!table.Has(id))
+            return;
+        int leaf = leafOf[id];
+        RemoveLeaf(leaf);
+        FreeNode(leaf);
+        leafOf[id] = NIL;
+        table.Unset(id);
+    }
+    void Reserve(size_t n) override
+    {
+        table.Reserve(n);
+        nodes.reserve(2 * n); // n leaves + n - 1 internal nodes
+        leafOf.reserve(n);
+        stack.reserve(128);
+    }
+    void Clear() override
+    {
+        table.Clear();
+        nodes.clear();
+        leafOf.clear();
+        root = NIL;
+        freeList = NIL;
+    }
+
+    // Descend the tree against itself: each node pair whose boxes overlap is visited once,
+    // instead of running a separate query per leaf.
+    void FindPairs(std::vector<ProxyPair> &out) override
+    {
+        out.clear();
+        if (root == NIL)
+            return;
+        pairStack.clear();
+        pairStack.push_back({root, root});
+        while (!pairStack.empty())
+        {
+            int a = pairStack.back().first, b = pairStack.back().second;
+            pairStack.pop_back();
+            const Node &A = nodes[a], &B = nodes[b];
+            if (a == b)
+            {
+                if (A.IsLeaf())
+                    continue;
+                pairStack.push_back({A.child1, A.child1});
+                pairStack.push_back({A.child2, A.child2});
+                pairStack.push_back({A.child1, A.child2});
+                continue;
+            }
+            if (!AABBOverlap(A.box, B.box))
+                continue;
+            if (A.IsLeaf() && B.IsLeaf())
+            {
+                if (AABBOverlap(table.boxes[A.id], table.boxes[B.id]))
+                    out.push_back(std::minmax(A.id, B.id));
+                continue;
+            }
+            // split the larger (or the only internal) node
+            if (B.IsLeaf() || (!A.IsLeaf() && A.height >= B.height))
+            {
+                pairStack.push_back({A.child1, b});
+                pairStack.push_back({A.child2, b});
+            }
+            else
+            {
+                pairStack.push_back({a, B.child1});
+                pairStack.push_back({a, B.child2});
+            }
+        }
+    }
+    void QueryAABB(const AABB &box, std::vector<ProxyId> &out) override
+    {
+        Query(box, [&](int node)
+              {
+                  ProxyId id = nodes[node].id;
+                  if (AABBOverlap(box, table.boxes[id]))
+                      out.push_back(id); });
+    }
+    void QueryRay(const glm::vec3 &origin, const glm::vec3 &dir, float maxT, std::vector<ProxyId> &out) override
+    {
+        if (root == NIL)
+            return;
+        glm::vec3 inv = SafeInverse(dir);
+        float t;
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            int n = stack.back();
+            stack.pop_back();
+            if (!RayAABB(origin, inv, nodes[n].box, maxT, t))
+                continue;
+            if (nodes[n].IsLeaf())
+            {
+                if (RayAABB(origin, inv, table.boxes[nodes[n].id], maxT, t))
+                    out.push_back(nodes[n].id);
+                continue;
+            }
+            stack.push_back(nodes[n].child1);
+            stack.push_back(nodes[n].child2);
+        }
+    }
+
+private:
+    static constexpr int NIL = -1;
+    static constexpr float MARGIN = 0.1f;
+
+    struct Node
+    {
+        AABB box;
+        int parent = NIL; // doubles as the free-list link
+        int child1 = NIL;
+        int child2 = NIL;
+        int height = 0; // leaf = 0, free = -1
+        ProxyId id = 0;
+        bool IsLeaf() const { return child1 == NIL; }
+    };
+
+    static AABB Fatten(const AABB &b) { return {b.min - glm::vec3(MARGIN), b.max + glm::vec3(MARGIN)}; }
+
+    template <typename Fn>
+    void Query(const AABB &box, Fn fn)
+    {
+        if (root == NIL)
+            return;
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            int n = stack.back();
+            stack.pop_back();
+            if (!AABBOverlap(nodes[n].box, box))
+                continue;
+            if (nodes[n].IsLeaf())
+                fn(n);
+            else
+            {
+                stack.push_back(nodes[n].child1);
+                stack.push_back(nodes[n].child2);
+            }
+        }
+    }
+
+    int AllocateNode()
+    {
+        if (freeList == NIL)
+        {
+            nodes.emplace_back();
+            return (int)nodes.size() - 1;
+        }
+        int n = freeList;
+        freeList = nodes[n].parent;
+        nodes[n] = Node();
+        return n;
+    }
+    void FreeNode(int n)
+    {
+        nodes[n].parent = freeList;
+        nodes[n].height = -1;
+        freeList = n;
+    }
+
+    void InsertLeaf(int leaf)
+    {
+        if (root == NIL)
+        {
+            root = leaf;
+            nodes[root].parent = NIL;
+            return;
+        }
+
+        // descend towards the sibling with the smallest increase in total surface area
+        AABB leafBox = nodes[leaf].box;
+        int index = root;
+        while (!nodes[index].IsLeaf())
+        {
+            int c1 = nodes[index].child1, c2 = nodes[index].child2;
+            float area = AABBSurfaceArea(nodes[index].box);
+            float combined = AABBSurfaceArea(AABBUnion(nodes[index].box, leafBox));
+            float cost = 2.0f * combined;                  // new parent here
+            float inherited = 2.0f * (combined - area);    // pushed down to every child below
+
+            auto childCost = [&](int c)
+            {
+                float grown = AABBSurfaceArea(AABBUnion(leafBox, nodes[c].box));
+                if (nodes[c].IsLeaf())
+                    return grown + inherited;
+                return grown - AABBSurfaceArea(nodes[c].box) + inherited;
+            };
+            float cost1 = childCost(c1), cost2 = childCost(c2);
+            if (cost < cost1 && cost < cost2)
+                break;
+            index = (cost1 < cost2) ? c1 : c2;
+        }
+
+        int sibling = index;
+        int oldParent = nodes[sibling].parent;
+        int newParent = AllocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = AABBUnion(leafBox, nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+        if (oldParent == NIL)
+            root = newParent;
+        else if (nodes[oldParent].child1 == sibling)
+            nodes[oldParent].child1 = newParent;
+        else
+            nodes[oldParent].child2 = newParent;
+
+        Refit(nodes[leaf].parent);
+    }
+
+    void RemoveLeaf(int leaf)
+    {
+        if (leaf == root)
+        {
+            root = NIL;
+            return;
+        }
+        int parent = nodes[leaf].parent;
+        int grandParent = nodes[parent].parent;
+        int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+        if (grandParent == NIL)
+        {
+            root = sibling;
+            nodes[sibling].parent = NIL;
+            FreeNode(parent);
+            return;
+        }
+        if (nodes[grandParent].child1 == parent)
+            nodes[grandParent].child1 = sibling;
+        else
+            nodes[grandParent].child2 = sibling;
+        nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+        Refit(grandParent);
+    }
+
+    // walk to the root fixing heights and boxes, rotating where the tree leans
+    void Refit(int index)
+    {
+        while (index != NIL)
+        {
+            index = Balance(index);
+            int c1 = nodes[index].child1, c2 = nodes[index].child2;
+            nodes[index].height = 1 + std::max(nodes[c1].height, nodes[c2].height);
+            nodes[index].box = AABBUnion(nodes[c1].box, nodes[c2].box);
+            index = nodes[index].parent;
+        }
+    }
+
+    // AVL-style rotation; returns the index of the subtree's new root
+    int Balance(int a)
+    {
+        Node &A = nodes[a];
+        if (A.IsLeaf() || A.height < 2)
+            return a;
+        int b = A.child1, c = A.child2;
+        int balance = nodes[c].height - nodes[b].height;
+        if (balance > 1)
+            return Rotate(a, c, b);
+        if (balance < -1)
+            return Rotate(a, b, c);
+        return a;
+    }
+
+    // lift the taller child `up` above `a`; `other` stays under a
+    int Rotate(int a, int up, int other)
+    {
+        int f = nodes[up].child1, g = nodes[up].child2;
+
+        nodes[up].child1 = a;
+        nodes[up].parent = nodes[a].parent;
+        nodes[a].parent = up;
+        if (nodes[up].parent == NIL)
+            root = up;
+        else if (nodes[nodes[up].parent].child1 == a)
+            nodes[nodes[up].parent].child1 = up;
+        else
+            nodes[nodes[up].parent].child2 = up;
+
+        // keep the taller grandchild under `up`, give the other one to `a`
+        int keep = (nodes[f].height > nodes[g].height) ? f : g;
+        int give = (keep == f) ? g : f;
+        nodes[up].child2 = keep;
+        if (nodes[a].child1 == up)
+            nodes[a].child1 = give;
+        else
+            nodes[a].child2 = give;
+        nodes[give].parent = a;
+
+        nodes[a].box = AABBUnion(nodes[other].box, nodes[give].box);
+        nodes[a].height = 1 + std::max(nodes[other].height, nodes[give].height);
+        nodes[up].box = AABBUnion(nodes[a].box, nodes[keep].box);
+        nodes[up].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+        return up;
+    }
+
+    ProxyTable table;
+    std::vector<Node> nodes;
+    std::vector<int> leafOf; // proxy id -> leaf node
+    std::vector<int> stack;  // reused traversal stacks
+    std::vector<std::pair<int, int>> pairStack;
+    int root = NIL;
+    int freeList = NIL;
+};
+
+std::unique_ptr<Broadphase> CreateBroadphase(BroadphaseType type, float cellSize)
+{
+    switch (type)
+    {
+    case BroadphaseType::BruteForce:
+        return std::unique_ptr<Broadphase>(new BruteForceBroadphase());
+    case BroadphaseType::SweepAndPrune:
+        return std::unique_ptr<Broadphase>(new SweepAndPruneBroadphase());
+    case BroadphaseType::UniformGrid:
+        return std::unique_ptr<Broadphase>(new UniformGridBroadphase(cellSize));
+    case BroadphaseType::AABBTree:
+        return std::unique_ptr<Broadphase>(new AABBTreeBroadphase());
+    }
+    return nullptr;
+}
@@ -0,0 +1,46 @@
+// src/Broadphase.h
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Collision.h"
+
+// Broadphases track one AABB per proxy id (small, dense ids chosen by the caller) and report
+// candidates whose boxes overlap. Exact shape tests are left to the caller (CollisionWorld).
+using ProxyId = uint32_t;
+using ProxyPair = std::pair<ProxyId, ProxyId>; // first < second
+
+enum class BroadphaseType
+{
+    BruteForce,    // test everything against everything; fine for a few dozen bodies
+    SweepAndPrune, // list kept sorted on x (insertion sort exploits frame-to-frame coherence)
+    UniformGrid,   // hashed grid of fixed-size cells; best when bodies are similar in size
+    AABBTree       // dynamic bounding volume tree with fattened leaves; good general default
+};
+
+const char *BroadphaseName(BroadphaseType type);
+
+class Broadphase
+{
+public:
+    virtual ~Broadphase() = default;
+
+    virtual void Insert(ProxyId id, const AABB &box) = 0;
+    virtual void Update(ProxyId id, const AABB &box) = 0;
+    virtual void Remove(ProxyId id) = 0;
+    virtual void Clear() = 0;
+    // optional: size internal storage for ids below n so later inserts don't allocate
+    virtual void Reserve(size_t n) { (void)n; }
+
+    // every pair of proxies whose AABBs overlap, each pair once (out is cleared first)
+    virtual void FindPairs(std::vector<ProxyPair> &out) = 0;
+    // proxies whose AABBs overlap box (appended to out)
+    virtual void QueryAABB(const AABB &box, std::vector<ProxyId> &out) = 0;
+    // proxies whose AABBs the ray origin + t*dir, t in [0, maxT], passes through (appended to out)
+    virtual void QueryRay(const glm::vec3 &origin, const glm::vec3 &dir, float maxT, std::vector<ProxyId> &out) = 0;
+};
+
+// cellSize is only used by the uniform grid (pick roughly the typical body size)
+std::unique_ptr<Broadphase> CreateBroadphase(BroadphaseType type, float cellSize = 1.0f);
@@ -0,0 +1,598 @@
+#include "Collision.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <cmath>
+
+#if HELLOGL_X86
+#include <immintrin.h>
+#endif
+
+OBB BuildOBBFromModel(const glm::vec3 &bboxMin,
+                      const glm::vec3 &bboxMax,
+                      const glm::mat4 &modelMatrix)
+{
+    // local center and half extents
+    glm::vec3 localCenter = (bboxMin + bboxMax) * 0.5f;
+    glm::vec3 localHalf = (bboxMax - bboxMin) * 0.5f;
+
+    // world center
+    glm::vec3 worldCenter = glm::vec3(modelMatrix * glm::vec4(localCenter, 1.0f));
+
+    // linear 3x3 part (rotation * scale)
+    glm::mat3 M3 = glm::mat3(modelMatrix);
+
+    OBB obb;
+    obb.center = worldCenter;
+
+    // for each local axis (unit vectors X,Y,Z), transform by M3:
+    // axis vector in world = normalize(M3 * unit)
+    // half-length in world = length(M3 * unit) * localHalf[i]
+    glm::vec3 ux = glm::vec3(M3 * glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::vec3 uy = glm::vec3(M3 * glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::vec3 uz = glm::vec3(M3 * glm::vec3(0.0f, 0.0f, 1.0f));
+
+    float lenx = glm::length(ux);
+    float leny = glm::length(uy);
+    float lenz = glm::length(uz);
+
+    // Avoid degenerate axes
+    obb.axis[0] = (lenx > 1e-6f) ? ux / lenx : glm::vec3(1, 0, 0);
+    obb.axis[1] = (leny > 1e-6f) ? uy / leny : glm::vec3(0, 1, 0);
+    obb.axis[2] = (lenz > 1e-6f) ? uz / lenz : glm::vec3(0, 0, 1);
+
+    obb.half[0] = lenx * localHalf.x;
+    obb.half[1] = leny * localHalf.y;
+    obb.half[2] = lenz * localHalf.z;
+
+    return obb;
+}
+bool OBBIntersectSAT(const OBB &A, const OBB &B)
+{
+    // vector from A to B
+    glm::vec3 T = B.center - A.center;
+
+    // list of 15 test axes: A.axis[0..2], B.axis[0..2], and cross products
+    // we will test each axis by projecting both boxes onto it
+
+    // convenience lambdas
+    auto projectIntervalRadius = [](const OBB &O, const glm::vec3 &axis) -> float
+    {
+        // axis assumed unit length
+        float r = 0.0f;
+        r += O.half[0] * fabs(glm::dot(O.axis[0], axis));
+        r += O.half[1] * fabs(glm::dot(O.axis[1], axis));
+        r += O.half[2] * fabs(glm::dot(O.axis[2], axis));
+        return r;
+    };
+
+    // test function for an axis (must be normalized)
+    auto testAxis = [&](const glm::vec3 &axis) -> bool
+    {
+        float axisLen2 = glm::dot(axis, axis);
+        if (axisLen2 < 1e-8f)
+            return true; // axis degenerate -> skip test (treat as non-separating)
+        glm::vec3 axisN = axis / (float)sqrt(axisLen2);
+        float dist = fabs(glm::dot(T, axisN));
+        float ra = projectIntervalRadius(A, axisN);
+        float rb = projectIntervalRadius(B, axisN);
+        return dist <= (ra + rb) + 1e-6f; // overlap if true
+    };
+
+    // 3 axes A
+    for (int i = 0; i < 3; i++)
+        if (!testAxis(A.axis[i]))
+            return false;
+    // 3 axes B
+    for (int i = 0; i < 3; i++)
+        if (!testAxis(B.axis[i]))
+            return false;
+    // 9 cross axes
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            glm::vec3 ax = glm::cross(A.axis[i], B.axis[j]);
+            if (!testAxis(ax))
+                return false;
+        }
+    }
+    // no separating axis found -> intersection
+    return true;
+}
+
+// ===== Gottschalk OBB test (scalar reference and batched SIMD kernels) =====
+// Every kernel evaluates the same expressions in the same order (no FMA), so a lane of
+// OBBOverlapBatch always agrees with OBBOverlap.
+static const float OBB_PARALLEL_EPS = 1e-6f;
+
+int OBBSeparatingAxis(const OBB &A, const OBB &B)
+{
+    float R[3][3], AR[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            R[i][j] = (A.axis[i].x * B.axis[j].x + A.axis[i].y * B.axis[j].y) + A.axis[i].z * B.axis[j].z;
+            AR[i][j] = fabsf(R[i][j]) + OBB_PARALLEL_EPS;
+        }
+    }
+    glm::vec3 t = B.center - A.center;
+    float T[3];
+    for (int i = 0; i < 3; ++i)
+        T[i] = (t.x * A.axis[i].x + t.y * A.axis[i].y) + t.z * A.axis[i].z;
+    const float *a = A.half;
+    const float *b = B.half;
+
+    // A's face axes
+    for (int i = 0; i < 3; ++i)
+    {
+        if (fabsf(T[i]) > a[i] + ((b[0] * AR[i][0] + b[1] * AR[i][1]) + b[2] * AR[i][2]))
+            return i;
+    }
+    // B's face axes
+    for (int j = 0; j < 3; ++j)
+    {
+        float d = (T[0] * R[0][j] + T[1] * R[1][j]) + T[2] * R[2][j];
+        if (fabsf(d) > ((a[0] * AR[0][j] + a[1] * AR[1][j]) + a[2] * AR[2][j]) + b[j])
+            return 3 + j;
+    }
+    // edge cross products A_i x B_j
+    for (int i = 0; i < 3; ++i)
+    {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j)
+        {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            float d = T[i2] * R[i1][j] - T[i1] * R[i2][j];
+            float ra = a[i1] * AR[i2][j] + a[i2] * AR[i1][j];
+            float rb = b[j1] * AR[i][j2] + b[j2] * AR[i][j1];
+            if (fabsf(d) > ra + rb)
+                return 6 + i * 3 + j;
+        }
+    }
+    return -1;
+}
+
+bool OBBOverlap(const OBB &A, const OBB &B)
+{
+    return OBBSeparatingAxis(A, B) < 0;
+}
+
+// Only the rotation and translation terms the one axis needs, each computed with the
+// same expression as above so the verdict matches that axis in the full test exactly.
+bool OBBSeparatedOnAxis(const OBB &A, const OBB &B, int axis)
+{
+    auto rot = [&](int i, int j)
+    { return (A.axis[i].x * B.axis[j].x + A.axis[i].y * B.axis[j].y) + A.axis[i].z * B.axis[j].z; };
+    glm::vec3 t = B.center - A.center;
+    auto trans = [&](int i)
+    { return (t.x * A.axis[i].x + t.y * A.axis[i].y) + t.z * A.axis[i].z; };
+    const float *a = A.half;
+    const float *b = B.half;
+
+    if (axis < 3)
+    {
+        int i = axis;
+        float ar0 = fabsf(rot(i, 0)) + OBB_PARALLEL_EPS;
+        float ar1 = fabsf(rot(i, 1)) + OBB_PARALLEL_EPS;
+        float ar2 = fabsf(rot(i, 2)) + OBB_PARALLEL_EPS;
+        return fabsf(trans(i)) > a[i] + ((b[0] * ar0 + b[1] * ar1) + b[2] * ar2);
+    }
+    if (axis < 6)
+    {
+        int j = axis - 3;
+        float r0 = rot(0, j), r1 = rot(1, j), r2 = rot(2, j);
+        float d = (trans(0) * r0 + trans(1) * r1) + trans(2) * r2;
+        float ra = (a[0] * (fabsf(r0) + OBB_PARALLEL_EPS) + a[1] * (fabsf(r1) + OBB_PARALLEL_EPS)) +
+                   a[2] * (fabsf(r2) + OBB_PARALLEL_EPS);
+        return fabsf(d) > ra + b[j];
+    }
+    int i = (axis - 6) / 3, j = (axis - 6) % 3;
+    int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+    int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+    float r1 = rot(i1, j), r2 = rot(i2, j);
+    float d = trans(i2) * r1 - trans(i1) * r2;
+    float ra = a[i1] * (fabsf(r2) + OBB_PARALLEL_EPS) + a[i2] * (fabsf(r1) + OBB_PARALLEL_EPS);
+    float rb = b[j1] * (fabsf(rot(i, j2)) + OBB_PARALLEL_EPS) + b[j2] * (fabsf(rot(i, j1)) + OBB_PARALLEL_EPS);
+    return fabsf(d) > ra + rb;
+}
+
+int OBBBatch::Add(const OBB &box)
+{
+    int lane = count++;
+    cx[lane] = box.center.x;
+    cy[lane] = box.center.y;
+    cz[lane] = box.center.z;
+    for (int k = 0; k < 3; ++k)
+    {
+        ax[k][lane] = box.axis[k].x;
+        ay[k][lane] = box.axis[k].y;
+        az[k][lane] = box.axis[k].z;
+        half[k][lane] = box.half[k];
+    }
+    return lane;
+}
+
+#if HELLOGL_X86
+// 4 lanes starting at base; returns a 4-bit mask of overlapping lanes.
+// If axisMask is given, bit (base + lane) of axisMask[k] is set when axis k separates that lane.
+static uint32_t OBBOverlapSSE2(const OBB &A, const OBBBatch &B, int base, uint32_t *axisMask)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 eps = _mm_set1_ps(OBB_PARALLEL_EPS);
+
+    __m128 R[3][3], AR[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+        __m128 x = _mm_set1_ps(A.axis[i].x), y = _mm_set1_ps(A.axis[i].y), z = _mm_set1_ps(A.axis[i].z);
+        for (int j = 0; j < 3; ++j)
+        {
+            R[i][j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_load_ps(&B.ax[j][base])),
+                                            _mm_mul_ps(y, _mm_load_ps(&B.ay[j][base]))),
+                                 _mm_mul_ps(z, _mm_load_ps(&B.az[j][base])));
+            AR[i][j] = _mm_add_ps(_mm_and_ps(R[i][j], absMask), eps);
+        }
+    }
+    __m128 tx = _mm_sub_ps(_mm_load_ps(&B.cx[base]), _mm_set1_ps(A.center.x));
+    __m128 ty = _mm_sub_ps(_mm_load_ps(&B.cy[base]), _mm_set1_ps(A.center.y));
+    __m128 tz = _mm_sub_ps(_mm_load_ps(&B.cz[base]), _mm_set1_ps(A.center.z));
+    __m128 T[3], a[3], b[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        T[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, _mm_set1_ps(A.axis[i].x)), _mm_mul_ps(ty, _mm_set1_ps(A.axis[i].y))),
+                          _mm_mul_ps(tz, _mm_set1_ps(A.axis[i].z)));
+        a[i] = _mm_set1_ps(A.half[i]);
+        b[i] = _mm_load_ps(&B.half[i][base]);
+    }
+
+    __m128 sep = _mm_setzero_ps();
+    for (int i = 0; i < 3; ++i)
+    {
+        __m128 rb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b[0], AR[i][0]), _mm_mul_ps(b[1], AR[i][1])), _mm_mul_ps(b[2], AR[i][2]));
+        __m128 s = _mm_cmpgt_ps(_mm_and_ps(T[i], absMask), _mm_add_ps(a[i], rb));
+        if (axisMask)
+            axisMask[i] |= (uint32_t)_mm_movemask_ps(s) << base;
+        sep = _mm_or_ps(sep, s);
+    }
+    for (int j = 0; j < 3; ++j)
+    {
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(T[0], R[0][j]), _mm_mul_ps(T[1], R[1][j])), _mm_mul_ps(T[2], R[2][j]));
+        __m128 ra = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], AR[0][j]), _mm_mul_ps(a[1], AR[1][j])), _mm_mul_ps(a[2], AR[2][j]));
+        __m128 s = _mm_cmpgt_ps(_mm_and_ps(d, absMask), _mm_add_ps(ra, b[j]));
+        if (axisMask)
+            axisMask[3 + j] |= (uint32_t)_mm_movemask_ps(s) << base;
+        sep = _mm_or_ps(sep, s);
+    }
+    // every lane already separated by a face axis: skip the 9 edge axes
+    if (_mm_movemask_ps(sep) == 0xF)
+        return 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j)
+        {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            __m128 d = _mm_sub_ps(_mm_mul_ps(T[i2], R[i1][j]), _mm_mul_ps(T[i1], R[i2][j]));
+            __m128 ra = _mm_add_ps(_mm_mul_ps(a[i1], AR[i2][j]), _mm_mul_ps(a[i2], AR[i1][j]));
+            __m128 rb = _mm_add_ps(_mm_mul_ps(b[j1], AR[i][j2]), _mm_mul_ps(b[j2], AR[i][j1]));
+            __m128 s = _mm_cmpgt_ps(_mm_and_ps(d, absMask), _mm_add_ps(ra, rb));
+            if (axisMask)
+                axisMask[6 + i * 3 + j] |= (uint32_t)_mm_movemask_ps(s) << base;
+            sep = _mm_or_ps(sep, s);
+        }
+    }
+    return (uint32_t)(~_mm_movemask_ps(sep) & 0xF);
+}
+
+HELLOGL_TARGET_AVX static uint32_t OBBOverlapAVX(const OBB &A, const OBBBatch &B, uint32_t *axisMask)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 eps = _mm256_set1_ps(OBB_PARALLEL_EPS);
+
+    __m256 R[3][3], AR[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+        __m256 x = _mm256_set1_ps(A.axis[i].x), y = _mm256_set1_ps(A.axis[i].y), z = _mm256_set1_ps(A.axis[i].z);
+        for (int j = 0; j < 3; ++j)
+        {
+            R[i][j] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_load_ps(B.ax[j])),
+                                                  _mm256_mul_ps(y, _mm256_load_ps(B.ay[j]))),
+                                    _mm256_mul_ps(z, _mm256_load_ps(B.az[j])));
+            AR[i][j] = _mm256_add_ps(_mm256_and_ps(R[i][j], absMask), eps);
+        }
+    }
+    __m256 tx = _mm256_sub_ps(_mm256_load_ps(B.cx), _mm256_set1_ps(A.center.x));
+    __m256 ty = _mm256_sub_ps(_mm256_load_ps(B.cy), _mm256_set1_ps(A.center.y));
+    __m256 tz = _mm256_sub_ps(_mm256_load_ps(B.cz), _mm256_set1_ps(A.center.z));
+    __m256 T[3], a[3], b[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        T[i] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, _mm256_set1_ps(A.axis[i].x)), _mm256_mul_ps(ty, _mm256_set1_ps(A.axis[i].y))),
+                             _mm256_mul_ps(tz, _mm256_set1_ps(A.axis[i].z)));
+        a[i] = _mm256_set1_ps(A.half[i]);
+        b[i] = _mm256_load_ps(B.half[i]);
+    }
+
+    __m256 sep = _mm256_setzero_ps();
+    for (int i = 0; i < 3; ++i)
+    {
+        __m256 rb = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b[0], AR[i][0]), _mm256_mul_ps(b[1], AR[i][1])), _mm256_mul_ps(b[2], AR[i][2]));
+        __m256 s = _mm256_cmp_ps(_mm256_and_ps(T[i], absMask), _mm256_add_ps(a[i], rb), _CMP_GT_OQ);
+        if (axisMask)
+            axisMask[i] = (uint32_t)_mm256_movemask_ps(s);
+        sep = _mm256_or_ps(sep, s);
+    }
+    for (int j = 0; j < 3; ++j)
+    {
+        __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(T[0], R[0][j]), _mm256_mul_ps(T[1], R[1][j])), _mm256_mul_ps(T[2], R[2][j]));
+        __m256 ra = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a[0], AR[0][j]), _mm256_mul_ps(a[1], AR[1][j])), _mm256_mul_ps(a[2], AR[2][j]));
+        __m256 s = _mm256_cmp_ps(_mm256_and_ps(d, absMask), _mm256_add_ps(ra, b[j]), _CMP_GT_OQ);
+        if (axisMask)
+            axisMask[3 + j] = (uint32_t)_mm256_movemask_ps(s);
+        sep = _mm256_or_ps(sep, s);
+    }
+    // every lane already separated by a face axis: skip the 9 edge axes
+    if (_mm256_movemask_ps(sep) == 0xFF)
+        return 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j)
+        {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            __m256 d = _mm256_sub_ps(_mm256_mul_ps(T[i2], R[i1][j]), _mm256_mul_ps(T[i1], R[i2][j]));
+            __m256 ra = _mm256_add_ps(_mm256_mul_ps(a[i1], AR[i2][j]), _mm256_mul_ps(a[i2], AR[i1][j]));
+            __m256 rb = _mm256_add_ps(_mm256_mul_ps(b[j1], AR[i][j2]), _mm256_mul_ps(b[j2], AR[i][j1]));
+            __m256 s = _mm256_cmp_ps(_mm256_and_ps(d, absMask), _mm256_add_ps(ra, rb), _CMP_GT_OQ);
+            if (axisMask)
+                axisMask[6 + i * 3 + j] = (uint32_t)_mm256_movemask_ps(s);
+            sep = _mm256_or_ps(sep, s);
+        }
+    }
+    return (uint32_t)(~_mm256_movemask_ps(sep) & 0xFF);
+}
+#endif
+
+uint32_t OBBOverlapBatch(const OBB &A, const OBBBatch &batch, int8_t *sepAxis)
+{
+    if (batch.count == 0)
+        return 0;
+    const uint32_t used = (1u << batch.count) - 1u;
+    uint32_t mask = 0;
+    // per-axis lane masks; axes skipped by the early out stay 0 (a face axis already separates)
+    uint32_t axisMask[15] = {};
+    uint32_t *masks = sepAxis ? axisMask : nullptr;
+#if HELLOGL_X86
+    const CpuFeatures &cpu = GetCpuFeatures();
+    if (cpu.avx)
+        mask = OBBOverlapAVX(A, batch, masks) & used;
+    else if (cpu.sse2)
+    {
+        mask = OBBOverlapSSE2(A, batch, 0, masks);
+        if (batch.count > 4)
+            mask |= OBBOverlapSSE2(A, batch, 4, masks) << 4;
+        mask &= used;
+    }
+    else
+#endif
+    {
+        for (int lane = 0; lane < batch.count; ++lane)
+        {
+            OBB B;
+            B.center = glm::vec3(batch.cx[lane], batch.cy[lane], batch.cz[lane]);
+            for (int k = 0; k < 3; ++k)
+            {
+                B.axis[k] = glm::vec3(batch.ax[k][lane], batch.ay[k][lane], batch.az[k][lane]);
+                B.half[k] = batch.half[k][lane];
+            }
+            int axis = OBBSeparatingAxis(A, B);
+            if (axis < 0)
+                mask |= 1u << lane;
+            else if (masks)
+                masks[axis] |= 1u << lane;
+        }
+    }
+
+    if (sepAxis)
+    {
+        // first separating axis of each lane, in the scalar test's order
+        for (int lane = 0; lane < batch.count; ++lane)
+        {
+            sepAxis[lane] = -1;
+            for (int k = 0; k < 15 && !((mask >> lane) & 1u); ++k)
+            {
+                if ((axisMask[k] >> lane) & 1u)
+                {
+                    sepAxis[lane] = (int8_t)k;
+                    break;
+                }
+            }
+        }
+    }
+    return mask;
+}
+
+LocalBox MakeLocalBox(const glm::vec3 &bboxMin, const glm::vec3 &bboxMax)
+{
+    LocalBox box;
+    box.center = (bboxMin + bboxMax) * 0.5f;
+    box.half = (bboxMax - bboxMin) * 0.5f;
+    return box;
+}
+
+BoundingSphere ComputeBoundingSphere(const std::vector<glm::vec3> &points)
+{
+    BoundingSphere s;
+    if (points.empty())
+        return s;
+
+    auto farthestFrom = [&](const glm::vec3 &q) -> const glm::vec3 &
+    {
+        size_t best = 0;
+        float bestD2 = -1.0f;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            glm::vec3 d = points[i] - q;
+            float d2 = glm::dot(d, d);
+            if (d2 > bestD2)
+            {
+                bestD2 = d2;
+                best = i;
+            }
+        }
+        return points[best];
+    };
+
+    // Ritter: start from an approximately most-distant pair, then grow to cover stragglers
+    glm::vec3 a = farthestFrom(points[0]);
+    glm::vec3 b = farthestFrom(a);
+    s.center = (a + b) * 0.5f;
+    s.radius = glm::length(b - a) * 0.5f;
+    for (const glm::vec3 &p : points)
+    {
+        glm::vec3 d = p - s.center;
+        float d2 = glm::dot(d, d);
+        if (d2 > s.radius * s.radius)
+        {
+            float dist = sqrtf(d2);
+            float newRadius = (s.radius + dist) * 0.5f;
+            s.center += d * ((newRadius - s.radius) / dist);
+            s.radius = newRadius;
+        }
+    }
+
+    // for box-like models the sphere around the bbox center can be tighter
+    glm::vec3 lo = points[0], hi = points[0];
+    for (const glm::vec3 &p : points)
+    {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    glm::vec3 boxCenter = (lo + hi) * 0.5f;
+    float boxR2 = 0.0f;
+    for (const glm::vec3 &p : points)
+    {
+        glm::vec3 d = p - boxCenter;
+        boxR2 = std::max(boxR2, glm::dot(d, d));
+    }
+    if (boxR2 < s.radius * s.radius)
+    {
+        s.center = boxCenter;
+        s.radius = sqrtf(boxR2);
+    }
+    return s;
+}
+
+OBB WorldOBB(const LocalBox &box, const glm::vec3 &pos, const glm::mat3 &rot, const glm::vec3 &scale)
+{
+    OBB obb;
+    obb.center = pos + rot * (box.center * scale);
+    for (int i = 0; i < 3; ++i)
+    {
+        obb.axis[i] = rot[i];
+        obb.half[i] = box.half[i] * fabs(scale[i]);
+    }
+    return obb;
+}
+
+BoundingSphere WorldSphere(const BoundingSphere &sphere, const glm::vec3 &pos, const glm::mat3 &rot, const glm::vec3 &scale)
+{
+    BoundingSphere w;
+    w.center = pos + rot * (sphere.center * scale);
+    w.radius = sphere.radius * std::max({fabs(scale.x), fabs(scale.y), fabs(scale.z)});
+    return w;
+}
+
+AABB OBBBounds(const OBB &box)
+{
+    glm::vec3 ext(0.0f);
+    for (int i = 0; i < 3; ++i)
+        ext += glm::abs(box.axis[i]) * box.half[i];
+    return {box.center - ext, box.center + ext};
+}
+
+bool RayAABB(const glm::vec3 &origin, const glm::vec3 &invDir, const AABB &box, float maxT, float &outT)
+{
+    float tMin = 0.0f, tMax = maxT;
+    for (int k = 0; k < 3; ++k)
+    {
+        float t0 = (box.min[k] - origin[k]) * invDir[k];
+        float t1 = (box.max[k] - origin[k]) * invDir[k];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        // NaN (origin on a slab plane of a parallel ray) leaves the interval unchanged
+        tMin = (t0 > tMin) ? t0 : tMin;
+        tMax = (t1 < tMax) ? t1 : tMax;
+        if (tMin > tMax)
+            return false;
+    }
+    outT = tMin;
+    return true;
+}
+
+bool RayOBB(const glm::vec3 &origin, const glm::vec3 &dir, const OBB &box, float maxT, float &outT)
+{
+    // express the ray in the box frame, where the box is an AABB around the origin
+    glm::vec3 d = origin - box.center;
+    glm::vec3 o(glm::dot(d, box.axis[0]), glm::dot(d, box.axis[1]), glm::dot(d, box.axis[2]));
+    glm::vec3 r(glm::dot(dir, box.axis[0]), glm::dot(dir, box.axis[1]), glm::dot(dir, box.axis[2]));
+    glm::vec3 h(box.half[0], box.half[1], box.half[2]);
+    return RayAABB(o, 1.0f / r, AABB{-h, h}, maxT, outT);
+}
+
+float PointOBBDistance(const glm::vec3 &p, const OBB &box)
+{
+    // offset from the box along each of its axes, clamped to the faces
+    glm::vec3 d = p - box.center;
+    float dist2 = 0.0f;
+    for (int i = 0; i < 3; ++i)
+    {
+        float excess = fabs(glm::dot(d, box.axis[i])) - box.half[i];
+        if (excess > 0.0f)
+            dist2 += excess * excess;
+    }
+    return sqrtf(dist2);
+}
+
+bool SweptSphereOBB(const glm::vec3 &c0, const glm::vec3 &c1, float radius,
+                    const OBB &box, float &outT)
+{
+    const int MAX_ITERS = 32;
+    const float TOLERANCE = 1e-3f;
+
+    glm::vec3 move = c1 - c0;
+    float moveLen = glm::length(move);
+    float t = 0.0f;
+    for (int it = 0; it < MAX_ITERS; ++it)
+    {
+        // the sphere cannot reach the box before covering the current gap,
+        // so advancing by gap / speed never steps past the first contact
+        float gap = PointOBBDistance(c0 + move * t, box) - radius;
+        if (gap <= TOLERANCE)
+        {
+            outT = t;
+            return true;
+        }
+        if (moveLen < 1e-8f)
+            return false;
+        t += gap / moveLen;
+        if (t > 1.0f)
+            return false;
+    }
+    // still converging (grazing approach): report the contact, callers confirm it
+    outT = t;
+    return true;
+}
+
+bool FloorTimeOfImpact(float y0, float y1, float floorY, float &outT)
+{
+    if (y0 <= floorY)
+    {
+        outT = 0.0f;
+        return true;
+    }
+    if (y1 > floorY)
+        return false;
+    outT = (y0 - floorY) / (y0 - y1);
+    return true;
+}
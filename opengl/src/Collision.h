@@ -0,0 +1,132 @@
+// src/Collision.h
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ConvexHull.h"
+
+struct OBB
+{
+    glm::vec3 center;  // world-space center
+    glm::vec3 axis[3]; // orthonormal axes in world space (unit vectors)
+    float half[3];     // half-lengths along each axis (world units)
+};
+
+// modelMatrix 是实例的完整世界变换矩阵 (translate*rotate*scale)
+// bboxMin/max are in model-local coordinates
+OBB BuildOBBFromModel(const glm::vec3 &bboxMin,
+                      const glm::vec3 &bboxMax,
+                      const glm::mat4 &modelMatrix);
+// returns true if obbA and obbB overlap
+bool OBBIntersectSAT(const OBB &A, const OBB &B);
+
+// Same 15-axis test in Gottschalk's formulation: B's rotation expressed in A's frame and
+// its absolute value (plus an epsilon so near-parallel edge axes stay conservative) are
+// computed once, so no axis is normalized and every radius is a 3-term dot product.
+bool OBBOverlap(const OBB &A, const OBB &B);
+// The same test, reporting the first axis that separates the boxes (-1 if they overlap).
+// Axes are numbered 0-2 for A's faces, 3-5 for B's faces and 6 + 3*i + j for A_i x B_j.
+int OBBSeparatingAxis(const OBB &A, const OBB &B);
+// Test a single axis of that numbering; true means it separates the boxes, with exactly the
+// verdict the full test reaches on that axis. Cheap check for an axis cached from last tick.
+bool OBBSeparatedOnAxis(const OBB &A, const OBB &B, int axis);
+
+// Up to 8 boxes in SoA layout, tested against one box by OBBOverlapBatch
+struct OBBBatch
+{
+    static constexpr int SIZE = 8;
+    alignas(32) float cx[SIZE] = {}, cy[SIZE] = {}, cz[SIZE] = {};
+    alignas(32) float ax[3][SIZE] = {}, ay[3][SIZE] = {}, az[3][SIZE] = {}; // axis k, per component
+    alignas(32) float half[3][SIZE] = {};
+    int count = 0;
+
+    bool Full() const { return count == SIZE; }
+    void Clear() { count = 0; }
+    // append a box; returns its lane
+    int Add(const OBB &box);
+};
+
+// Test A against every box of the batch at once (AVX: 8 lanes, SSE2: 2 x 4 lanes, else scalar).
+// Bit i of the result is set when box i overlaps A; each lane decides exactly like OBBOverlap.
+// If sepAxis is given, sepAxis[i] receives what OBBSeparatingAxis would return for box i.
+uint32_t OBBOverlapBatch(const OBB &A, const OBBBatch &batch, int8_t *sepAxis = nullptr);
+
+// ===== Precomputed model bounds =====
+// Box in model-local space (before modelScale)
+struct LocalBox
+{
+    glm::vec3 center = glm::vec3(0.0f);
+    glm::vec3 half = glm::vec3(0.0f);
+};
+
+struct BoundingSphere
+{
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
+// Collision metadata computed once when a model is loaded
+struct ModelCollision
+{
+    LocalBox box;                  // whole model
+    BoundingSphere sphere;         // tight sphere over the vertices (Ritter)
+    std::vector<LocalBox> meshBox; // one per mesh, same order as the model's meshes
+    ConvexHull hull;               // reduced convex hull for the GJK narrowphase (may be empty)
+};
+
+// vertex budget of ModelCollision::hull; GJK support queries are linear in it
+static constexpr int HULL_MAX_VERTICES = 48;
+
+LocalBox MakeLocalBox(const glm::vec3 &bboxMin, const glm::vec3 &bboxMax);
+// Ritter's approximate minimal sphere, or the box-centred sphere when that is smaller
+BoundingSphere ComputeBoundingSphere(const std::vector<glm::vec3> &points);
+
+// World OBB of a precomputed box placed at pos with rotation rot (the same 3x3 that
+// ComposeTRS puts in the model matrix) and per-axis scale; no sqrt/normalize needed.
+OBB WorldOBB(const LocalBox &box, const glm::vec3 &pos, const glm::mat3 &rot, const glm::vec3 &scale);
+// World bounding sphere under the same transform
+BoundingSphere WorldSphere(const BoundingSphere &sphere, const glm::vec3 &pos, const glm::mat3 &rot, const glm::vec3 &scale);
+
+// ===== Axis-aligned bounds and rays =====
+struct AABB
+{
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+};
+
+inline bool AABBOverlap(const AABB &a, const AABB &b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+inline AABB AABBUnion(const AABB &a, const AABB &b) { return {glm::min(a.min, b.min), glm::max(a.max, b.max)}; }
+inline float AABBSurfaceArea(const AABB &a)
+{
+    glm::vec3 d = a.max - a.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// tightest world AABB around an OBB
+AABB OBBBounds(const OBB &box);
+// slab test; on a hit in [0, maxT] returns the entry distance (0 if the origin is inside).
+// invDir = 1 / dir per component (infinities are fine)
+bool RayAABB(const glm::vec3 &origin, const glm::vec3 &invDir, const AABB &box, float maxT, float &outT);
+// ray against an OBB (slab test in the box frame); dir need not be normalized, t is in units of dir
+bool RayOBB(const glm::vec3 &origin, const glm::vec3 &dir, const OBB &box, float maxT, float &outT);
+
+// ===== Continuous collision =====
+// Motion is linear within a tick (the integrator moves pos by vel*dt), so sweeps are
+// parameterised by t in [0,1] from the tick's start to its end.
+
+// distance from p to the surface of box (0 when p is inside)
+float PointOBBDistance(const glm::vec3 &p, const OBB &box);
+
+// Conservative advancement of a sphere moving from c0 to c1 against a static box.
+// On contact returns true with the first time of impact in outT.
+bool SweptSphereOBB(const glm::vec3 &c0, const glm::vec3 &c1, float radius,
+                    const OBB &box, float &outT);
+
+// Time at which a height moving linearly from y0 to y1 drops to floorY.
+// Returns false if it stays above floorY for the whole tick.
+bool FloorTimeOfImpact(float y0, float y1, float floorY, float &outT);
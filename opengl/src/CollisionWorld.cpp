@@ -0,0 +1,107 @@
+// src/CollisionWorld.cpp
+#include "CollisionWorld.h"
+#include <algorithm>
+
+CollisionWorld::CollisionWorld(BroadphaseType type, float cellSize)
+{
+    SetBroadphase(type, cellSize);
+}
+
+void CollisionWorld::SetBroadphase(BroadphaseType type, float cellSize)
+{
+    broadphaseType = type;
+    broadphase = CreateBroadphase(type, cellSize);
+    for (BodyId id = 0; id < bodies.size(); ++id)
+        if (bodies[id].alive)
+            broadphase->Insert(id, OBBBounds(bodies[id].box));
+}
+
+BodyId CollisionWorld::Add(const OBB &box, uint32_t userData)
+{
+    BodyId id;
+    if (!freeIds.empty())
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else
+    {
+        id = (BodyId)bodies.size();
+        bodies.emplace_back();
+    }
+    bodies[id].box = box;
+    bodies[id].userData = userData;
+    bodies[id].alive = true;
+    ++liveCount;
+    broadphase->Insert(id, OBBBounds(box));
+    return id;
+}
+
+void CollisionWorld::Move(BodyId id, const OBB &box)
+{
+    bodies[id].box = box;
+    broadphase->Update(id, OBBBounds(box));
+}
+
+void CollisionWorld::Remove(BodyId id)
+{
+    if (id >= bodies.size() || !bodies[id].alive)
+        return;
+    broadphase->Remove(id);
+    bodies[id].alive = false;
+    freeIds.push_back(id);
+    --liveCount;
+}
+
+void CollisionWorld::Clear()
+{
+    bodies.clear();
+    freeIds.clear();
+    liveCount = 0;
+    broadphase->Clear();
+}
+
+void CollisionWorld::FindOverlappingPairs(std::vector<ProxyPair> &out)
+{
+    out.clear();
+    broadphase->FindPairs(candidatePairs);
+    for (const ProxyPair &p : candidatePairs)
+        if (OBBOverlap(bodies[p.first].box, bodies[p.second].box))
+            out.push_back(p);
+    // broadphases report in their own traversal order; sort so results are reproducible
+    std::sort(out.begin(), out.end());
+}
+
+void CollisionWorld::QueryOverlap(const OBB &box, std::vector<BodyId> &out)
+{
+    candidates.clear();
+    broadphase->QueryAABB(OBBBounds(box), candidates);
+    std::sort(candidates.begin(), candidates.end());
+    for (ProxyId id : candidates)
+        if (OBBOverlap(box, bodies[id].box))
+            out.push_back(id);
+}
+
+bool CollisionWorld::RayCast(const glm::vec3 &origin, const glm::vec3 &dir, float maxT, RayHit &hit)
+{
+    candidates.clear();
+    broadphase->QueryRay(origin, dir, maxT, candidates);
+
+    bool found = false;
+    float best = maxT;
+    for (ProxyId id : candidates)
+    {
+        float t;
+        if (!RayOBB(origin, dir, bodies[id].box, best, t))
+            continue;
+        // ties go to the lower id, whatever order the broadphase returned them in
+        if (!found || t < best || (t == best && id < hit.body))
+        {
+            best = t;
+            hit.body = id;
+            hit.t = t;
+            found = true;
+        }
+    }
+    return found;
+}
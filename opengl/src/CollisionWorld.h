@@ -0,0 +1,64 @@
+// src/CollisionWorld.h
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Broadphase.h"
+#include "Collision.h"
+
+// A set of OBB bodies with a pluggable broadphase. Bodies are addressed by BodyId, which
+// stays valid until Remove (ids of removed bodies are reused). The broadphase only produces
+// candidates; every result below is confirmed with the exact OBB test.
+using BodyId = uint32_t;
+
+struct RayHit
+{
+    BodyId body = 0;
+    float t = 0.0f; // distance along the ray, in units of dir
+};
+
+class CollisionWorld
+{
+public:
+    explicit CollisionWorld(BroadphaseType type = BroadphaseType::AABBTree, float cellSize = 1.0f);
+
+    // Swap the broadphase; all bodies are re-inserted into the new one
+    void SetBroadphase(BroadphaseType type, float cellSize = 1.0f);
+    BroadphaseType GetBroadphaseType() const { return broadphaseType; }
+
+    BodyId Add(const OBB &box, uint32_t userData = 0);
+    void Move(BodyId id, const OBB &box);
+    void Remove(BodyId id);
+    void Clear();
+
+    size_t size() const { return liveCount; }
+    const OBB &Shape(BodyId id) const { return bodies[id].box; }
+    uint32_t UserData(BodyId id) const { return bodies[id].userData; }
+
+    // All overlapping body pairs, sorted (first < second), independent of the broadphase used
+    void FindOverlappingPairs(std::vector<ProxyPair> &out);
+    // Bodies overlapping box (appended to out, in ascending id order)
+    void QueryOverlap(const OBB &box, std::vector<BodyId> &out);
+    // Closest body hit by origin + t*dir, t in [0, maxT]
+    bool RayCast(const glm::vec3 &origin, const glm::vec3 &dir, float maxT, RayHit &hit);
+
+private:
+    struct Body
+    {
+        OBB box;
+        uint32_t userData = 0;
+        bool alive = false;
+    };
+
+    std::vector<Body> bodies;
+    std::vector<BodyId> freeIds;
+    size_t liveCount = 0;
+
+    BroadphaseType broadphaseType;
+    std::unique_ptr<Broadphase> broadphase;
+
+    // scratch buffers reused between queries
+    std::vector<ProxyPair> candidatePairs;
+    std::vector<ProxyId> candidates;
+};
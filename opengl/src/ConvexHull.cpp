@@ -0,0 +1,602 @@
+// src/ConvexHull.cpp
+#include "ConvexHull.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+// ===== Quickhull =====
+namespace
+{
+struct HullFace
+{
+    int v[3];
+    glm::vec3 n; // outward unit normal
+    float d;     // plane offset: dot(n, x) = d on the face
+    std::vector<int> outside;
+    bool alive = true;
+};
+
+uint64_t EdgeKey(int from, int to) { return ((uint64_t)(uint32_t)from << 32) | (uint32_t)to; }
+
+class Quickhull
+{
+public:
+    Quickhull(const std::vector<glm::vec3> &pts) : p(pts) {}
+
+    // indices of the hull vertices; empty if the points are degenerate (flat or fewer than 4)
+    std::vector<int> Run()
+    {
+        if (p.size() < 4 || !InitialSimplex())
+            return {};
+
+        for (size_t f = 0; f < faces.size(); ++f)
+        {
+            if (!faces[f].alive || faces[f].outside.empty())
+                continue;
+            AddPoint((int)f);
+            // faces grow during AddPoint; keep scanning from the start of the new ones
+        }
+
+        std::vector<int> verts;
+        std::vector<uint8_t> used(p.size(), 0);
+        for (const HullFace &f : faces)
+            if (f.alive)
+                for (int k = 0; k < 3; ++k)
+                    if (!used[f.v[k]])
+                    {
+                        used[f.v[k]] = 1;
+                        verts.push_back(f.v[k]);
+                    }
+        return verts;
+    }
+
+    // face planes of the hull found by Run, as (outward unit normal, offset)
+    std::vector<glm::vec4> Planes() const
+    {
+        std::vector<glm::vec4> planes;
+        for (const HullFace &f : faces)
+            if (f.alive)
+                planes.push_back(glm::vec4(f.n, f.d));
+        return planes;
+    }
+
+private:
+    const std::vector<glm::vec3> &p;
+    std::vector<HullFace> faces;
+    std::unordered_map<uint64_t, int> edgeFace; // directed edge -> face that owns it
+    float eps = 0.0f;
+
+    float Dist(const HullFace &f, int i) const { return glm::dot(f.n, p[i]) - f.d; }
+
+    int AddFace(int a, int b, int c)
+    {
+        HullFace f;
+        f.v[0] = a;
+        f.v[1] = b;
+        f.v[2] = c;
+        glm::vec3 n = glm::cross(p[b] - p[a], p[c] - p[a]);
+        float len = glm::length(n);
+        f.n = (len > 0.0f) ? n / len : glm::vec3(0.0f, 1.0f, 0.0f);
+        f.d = glm::dot(f.n, p[a]);
+        int id = (int)faces.size();
+        faces.push_back(std::move(f));
+        edgeFace[EdgeKey(a, b)] = id;
+        edgeFace[EdgeKey(b, c)] = id;
+        edgeFace[EdgeKey(c, a)] = id;
+        return id;
+    }
+
+    // give each point to the face it is furthest above (points above no face are inside)
+    void Assign(const std::vector<int> &points, const std::vector<int> &targets)
+    {
+        for (int i : points)
+        {
+            int best = -1;
+            float bestDist = eps;
+            for (int f : targets)
+            {
+                float d = Dist(faces[f], i);
+                if (d > bestDist)
+                {
+                    bestDist = d;
+                    best = f;
+                }
+            }
+            if (best >= 0)
+                faces[best].outside.push_back(i);
+        }
+    }
+
+    bool InitialSimplex()
+    {
+        glm::vec3 lo = p[0], hi = p[0];
+        int ext[6] = {0, 0, 0, 0, 0, 0};
+        for (int i = 0; i < (int)p.size(); ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                if (p[i][k] < p[ext[k]][k])
+                    ext[k] = i;
+                if (p[i][k] > p[ext[3 + k]][k])
+                    ext[3 + k] = i;
+            }
+            lo = glm::min(lo, p[i]);
+            hi = glm::max(hi, p[i]);
+        }
+        glm::vec3 size = hi - lo;
+        eps = 1e-5f * (size.x + size.y + size.z);
+
+        // two most distant axis extremes
+        int a = ext[0], b = ext[3];
+        float best = -1.0f;
+        for (int i = 0; i < 6; ++i)
+            for (int j = i + 1; j < 6; ++j)
+            {
+                glm::vec3 d = p[ext[i]] - p[ext[j]];
+                if (glm::dot(d, d) > best)
+                {
+                    best = glm::dot(d, d);
+                    a = ext[i];
+                    b = ext[j];
+                }
+            }
+        if (best <= eps * eps)
+            return false;
+
+        // furthest from the line ab, then furthest from the plane abc
+        glm::vec3 ab = glm::normalize(p[b] - p[a]);
+        int c = -1;
+        best = eps * eps;
+        for (int i = 0; i < (int)p.size(); ++i)
+        {
+            glm::vec3 d = glm::cross(p[i] - p[a], ab);
+            if (glm::dot(d, d) > best)
+            {
+                best = glm::dot(d, d);
+                c = i;
+            }
+        }
+        if (c < 0)
+            return false;
+        glm::vec3 n = glm::normalize(glm::cross(p[b] - p[a], p[c] - p[a]));
+        int d = -1;
+        best = eps;
+        for (int i = 0; i < (int)p.size(); ++i)
+        {
+            float dist = std::fabs(glm::dot(p[i] - p[a], n));
+            if (dist > best)
+            {
+                best = dist;
+                d = i;
+            }
+        }
+        if (d < 0)
+            return false;
+
+        // wind every face so its normal points away from the fourth vertex
+        if (glm::dot(p[d] - p[a], n) > 0.0f)
+            std::swap(b, c);
+        AddFace(a, b, c);
+        AddFace(a, d, b);
+        AddFace(b, d, c);
+        AddFace(c, d, a);
+
+        std::vector<int> all(p.size());
+        for (int i = 0; i < (int)p.size(); ++i)
+            all[i] = i;
+        Assign(all, {0, 1, 2, 3});
+        return true;
+    }
+
+    void AddPoint(int face)
+    {
+        // furthest outside point of this face becomes the new hull vertex
+        const HullFace &f0 = faces[face];
+        int eye = f0.outside[0];
+        for (int i : f0.outside)
+            if (Dist(f0, i) > Dist(f0, eye))
+                eye = i;
+
+        // faces the eye can see, flood-filled from this one across shared edges
+        std::vector<int> visible{face}, stack{face};
+        std::vector<uint8_t> isVisible(faces.size(), 0);
+        isVisible[face] = 1;
+        while (!stack.empty())
+        {
+            int f = stack.back();
+            stack.pop_back();
+            for (int k = 0; k < 3; ++k)
+            {
+                auto it = edgeFace.find(EdgeKey(faces[f].v[(k + 1) % 3], faces[f].v[k]));
+                if (it == edgeFace.end())
+                    continue;
+                int g = it->second;
+                if (isVisible[g] || Dist(faces[g], eye) <= eps)
+                    continue;
+                isVisible[g] = 1;
+                visible.push_back(g);
+                stack.push_back(g);
+            }
+        }
+
+        // horizon: edges of visible faces whose neighbour is not visible
+        std::vector<std::pair<int, int>> horizon;
+        std::vector<int> orphans;
+        for (int f : visible)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                int u = faces[f].v[k], v = faces[f].v[(k + 1) % 3];
+                auto it = edgeFace.find(EdgeKey(v, u));
+                if (it == edgeFace.end() || !isVisible[it->second])
+                    horizon.push_back({u, v});
+            }
+            for (int i : faces[f].outside)
+                if (i != eye)
+                    orphans.push_back(i);
+        }
+        for (int f : visible)
+        {
+            for (int k = 0; k < 3; ++k)
+                edgeFace.erase(EdgeKey(faces[f].v[k], faces[f].v[(k + 1) % 3]));
+            faces[f].alive = false;
+            std::vector<int>().swap(faces[f].outside);
+        }
+
+        std::vector<int> created;
+        for (const auto &e : horizon)
+            created.push_back(AddFace(e.first, e.second, eye));
+        Assign(orphans, created);
+    }
+};
+
+// Directions spread evenly over the sphere (Fibonacci lattice)
+std::vector<glm::vec3> SphereDirections(int n)
+{
+    std::vector<glm::vec3> dirs;
+    const float golden = 2.39996323f; // pi * (3 - sqrt(5))
+    for (int i = 0; i < n; ++i)
+    {
+        float y = 1.0f - 2.0f * ((float)i + 0.5f) / (float)n;
+        float r = std::sqrt(std::max(0.0f, 1.0f - y * y));
+        float phi = golden * (float)i;
+        dirs.push_back(glm::vec3(std::cos(phi) * r, y, std::sin(phi) * r));
+    }
+    return dirs;
+}
+} // namespace
+
+ConvexHull BuildConvexHull(const std::vector<glm::vec3> &pts, int maxVertices, int *hullVertices)
+{
+    ConvexHull hull;
+    if (pts.empty())
+        return hull;
+
+    std::vector<int> verts = Quickhull(pts).Run();
+    if (verts.empty())
+    {
+        // flat or tiny input: reduce the raw points instead
+        verts.resize(pts.size());
+        for (int i = 0; i < (int)pts.size(); ++i)
+            verts[i] = i;
+    }
+    if (hullVertices)
+        *hullVertices = (int)verts.size();
+
+    if ((int)verts.size() <= maxVertices)
+    {
+        for (int i : verts)
+            hull.points.push_back(pts[i]);
+        return hull;
+    }
+
+    // keep the extreme vertex along each direction: axes first, then evenly spread ones
+    std::vector<glm::vec3> dirs = {glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0),
+                                   glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1)};
+    std::vector<glm::vec3> spread = SphereDirections(std::max(maxVertices - 6, 0));
+    dirs.insert(dirs.end(), spread.begin(), spread.end());
+
+    std::vector<uint8_t> taken(pts.size(), 0);
+    for (const glm::vec3 &d : dirs)
+    {
+        if ((int)hull.points.size() >= maxVertices)
+            break;
+        int best = verts[0];
+        float bestDot = glm::dot(pts[best], d);
+        for (int i : verts)
+        {
+            float t = glm::dot(pts[i], d);
+            if (t > bestDot)
+            {
+                bestDot = t;
+                best = i;
+            }
+        }
+        if (!taken[best])
+        {
+            taken[best] = 1;
+            hull.points.push_back(pts[best]);
+        }
+    }
+
+    // The kept vertices span a hull inside the exact one. Grow it about its centroid until
+    // every input point is inside, so GJK can only err towards a hit, never miss a real one.
+    Quickhull reducedHull(hull.points);
+    std::vector<int> reducedVerts = reducedHull.Run();
+    std::vector<glm::vec4> planes = reducedHull.Planes();
+    glm::vec3 centroid(0.0f);
+    for (const glm::vec3 &q : hull.points)
+        centroid += q;
+    centroid /= (float)hull.points.size();
+    float scale = 1.0f;
+    bool ok = !reducedVerts.empty();
+    for (const glm::vec4 &pl : planes)
+    {
+        glm::vec3 n(pl);
+        float inside = pl.w - glm::dot(n, centroid); // centroid's depth below the face
+        if (inside <= 1e-6f)
+        {
+            ok = false; // flat reduced hull: no interior to grow from
+            break;
+        }
+        for (const glm::vec3 &q : pts)
+            scale = std::max(scale, glm::dot(n, q - centroid) / inside);
+    }
+    if (!ok)
+    {
+        // keep the exact hull rather than one that could miss contacts
+        hull.points.clear();
+        for (int i : verts)
+            hull.points.push_back(pts[i]);
+        return hull;
+    }
+    scale *= 1.0f + 1e-5f; // rounding margin
+    for (glm::vec3 &q : hull.points)
+        q = centroid + (q - centroid) * scale;
+    return hull;
+}
+
+// ===== Disk cache =====
+static const char HULL_MAGIC[4] = {'H', 'G', 'L', 'H'};
+static const uint32_t HULL_VERSION = 2; // 2: reduced hulls grown to contain the exact hull
+
+uint64_t HullSourceHash(const std::vector<glm::vec3> &pts, int maxVertices)
+{
+    // FNV-1a over the raw point data
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](const void *data, size_t n)
+    {
+        const unsigned char *b = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < n; ++i)
+        {
+            h ^= b[i];
+            h *= 1099511628211ull;
+        }
+    };
+    uint32_t header[2] = {HULL_VERSION, (uint32_t)maxVertices};
+    mix(header, sizeof(header));
+    if (!pts.empty())
+        mix(pts.data(), pts.size() * sizeof(glm::vec3));
+    return h;
+}
+
+bool LoadHullCache(const std::string &path, uint64_t sourceHash, ConvexHull &hull)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0, count = 0;
+    uint64_t hash = 0;
+    if (!in || !in.read(magic, 4) || std::memcmp(magic, HULL_MAGIC, 4) != 0 ||
+        !in.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != HULL_VERSION ||
+        !in.read(reinterpret_cast<char *>(&hash), sizeof(hash)) || hash != sourceHash ||
+        !in.read(reinterpret_cast<char *>(&count), sizeof(count)) || count > (1u << 16))
+        return false;
+    std::vector<glm::vec3> points(count);
+    if (count && !in.read(reinterpret_cast<char *>(points.data()), count * sizeof(glm::vec3)))
+        return false;
+    hull.points.swap(points);
+    return true;
+}
+
+bool SaveHullCache(const std::string &path, uint64_t sourceHash, const ConvexHull &hull)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+    uint32_t count = (uint32_t)hull.points.size();
+    out.write(HULL_MAGIC, 4);
+    out.write(reinterpret_cast<const char *>(&HULL_VERSION), sizeof(HULL_VERSION));
+    out.write(reinterpret_cast<const char *>(&sourceHash), sizeof(sourceHash));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char *>(hull.points.data()), count * sizeof(glm::vec3));
+    return (bool)out;
+}
+
+// ===== GJK =====
+static glm::vec3 Support(const HullPose &pose, const glm::vec3 &dir)
+{
+    // maximize dot(dir, pos + rot*(scale*p)) = const + dot(scale * rot^T dir, p)
+    glm::vec3 local = pose.scale * (glm::transpose(pose.rot) * dir);
+    const std::vector<glm::vec3> &pts = pose.hull->points;
+    size_t best = 0;
+    float bestDot = glm::dot(local, pts[0]);
+    for (size_t i = 1; i < pts.size(); ++i)
+    {
+        float t = glm::dot(local, pts[i]);
+        if (t > bestDot)
+        {
+            bestDot = t;
+            best = i;
+        }
+    }
+    return pose.pos + pose.rot * (pose.scale * pts[best]);
+}
+
+// Simplex of the Minkowski difference A - B (1 to 4 points)
+struct Simplex
+{
+    glm::vec3 pts[4];
+    int n = 0;
+};
+
+// Closest point to the origin on triangle abc (Ericson, Real-Time Collision Detection 5.1.5).
+// keep receives the vertices of the feature it lies on.
+static glm::vec3 ClosestOnTriangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, Simplex &keep)
+{
+    glm::vec3 ab = b - a, ac = c - a;
+    float d1 = glm::dot(ab, -a), d2 = glm::dot(ac, -a);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+    {
+        keep.pts[0] = a;
+        keep.n = 1;
+        return a;
+    }
+    float d3 = glm::dot(ab, -b), d4 = glm::dot(ac, -b);
+    if (d3 >= 0.0f && d4 <= d3)
+    {
+        keep.pts[0] = b;
+        keep.n = 1;
+        return b;
+    }
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+    {
+        keep.pts[0] = a;
+        keep.pts[1] = b;
+        keep.n = 2;
+        return a + ab * (d1 / (d1 - d3));
+    }
+    float d5 = glm::dot(ab, -c), d6 = glm::dot(ac, -c);
+    if (d6 >= 0.0f && d5 <= d6)
+    {
+        keep.pts[0] = c;
+        keep.n = 1;
+        return c;
+    }
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+    {
+        keep.pts[0] = a;
+        keep.pts[1] = c;
+        keep.n = 2;
+        return a + ac * (d2 / (d2 - d6));
+    }
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+    {
+        keep.pts[0] = b;
+        keep.pts[1] = c;
+        keep.n = 2;
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+    float denom = 1.0f / (va + vb + vc);
+    keep.pts[0] = a;
+    keep.pts[1] = b;
+    keep.pts[2] = c;
+    keep.n = 3;
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Reduce s to the feature closest to the origin and return the closest point on it.
+// Returns false when the origin is inside the tetrahedron (the shapes overlap).
+static bool ReduceSimplex(Simplex &s, glm::vec3 &closest)
+{
+    Simplex keep;
+    switch (s.n)
+    {
+    case 1:
+        closest = s.pts[0];
+        return true;
+    case 2:
+    {
+        glm::vec3 a = s.pts[0], ab = s.pts[1] - a;
+        float t = glm::dot(-a, ab);
+        float len2 = glm::dot(ab, ab);
+        if (t <= 0.0f || len2 <= 0.0f)
+        {
+            s.n = 1;
+            closest = a;
+        }
+        else if (t >= len2)
+        {
+            s.pts[0] = s.pts[1];
+            s.n = 1;
+            closest = s.pts[0];
+        }
+        else
+            closest = a + ab * (t / len2);
+        return true;
+    }
+    case 3:
+        closest = ClosestOnTriangle(s.pts[0], s.pts[1], s.pts[2], keep);
+        s = keep;
+        return true;
+    default:
+    {
+        // closest point over the faces the origin lies outside of
+        static const int FACES[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+        bool outside = false;
+        float best = INFINITY;
+        for (const int *f : FACES)
+        {
+            const glm::vec3 &a = s.pts[f[0]], &b = s.pts[f[1]], &c = s.pts[f[2]], &d = s.pts[f[3]];
+            glm::vec3 n = glm::cross(b - a, c - a);
+            float sideOrigin = glm::dot(n, -a), sideD = glm::dot(n, d - a);
+            // a flat tetrahedron has no inside; all its faces are candidates
+            if (sideOrigin * sideD > 0.0f)
+                continue;
+            outside = true;
+            Simplex faceKeep;
+            glm::vec3 p = ClosestOnTriangle(a, b, c, faceKeep);
+            if (glm::dot(p, p) < best)
+            {
+                best = glm::dot(p, p);
+                closest = p;
+                keep = faceKeep;
+            }
+        }
+        if (!outside)
+            return false;
+        s = keep;
+        return true;
+    }
+    }
+}
+
+bool GJKOverlap(const HullPose &a, const HullPose &b, int *iterations)
+{
+    glm::vec3 dir = a.pos - b.pos;
+    if (glm::dot(dir, dir) < 1e-12f)
+        dir = glm::vec3(1.0f, 0.0f, 0.0f);
+
+    Simplex s;
+    s.pts[0] = Support(a, dir) - Support(b, -dir);
+    s.n = 1;
+    glm::vec3 v = s.pts[0]; // closest point of the simplex to the origin
+
+    for (int it = 1; it <= GJK_MAX_ITERATIONS; ++it)
+    {
+        if (iterations)
+            *iterations = it;
+        float v2 = glm::dot(v, v);
+        // origin on the simplex: touching counts as overlap
+        if (v2 < 1e-12f)
+            return true;
+        glm::vec3 p = Support(a, -v) - Support(b, v);
+        float vp = glm::dot(v, p);
+        // p did not pass the origin (-v separates the shapes), or no progress towards it:
+        // v is then the closest point of A - B and the shapes are a positive distance apart
+        if (vp > 0.0f || v2 - vp <= 1e-6f * v2)
+            return false;
+        s.pts[s.n++] = p;
+        if (!ReduceSimplex(s, v))
+            return true;
+        // the distance must shrink every iteration; when rounding stops that, the last
+        // distance is as close as float gets and it was still positive
+        if (glm::dot(v, v) >= v2)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+// src/ConvexHull.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Simplified convex hull of a model, in model space. Only the vertices are kept: GJK needs
+// nothing but support points, and a few dozen vertices keep every support query cheap.
+struct ConvexHull
+{
+    std::vector<glm::vec3> points;
+    bool empty() const { return points.empty(); }
+};
+
+// Quickhull over pts, then reduced to at most maxVertices hull vertices by keeping the
+// extreme vertex along a set of evenly spread directions (always including the six axis
+// extremes). Those vertices alone would span a hull inside the exact one, so they are scaled
+// about their centroid until it contains every point of pts: the reduced hull is
+// conservative and errs towards near-hits, never missed contacts. Inputs whose reduction is
+// flat keep the exact hull. hullVertices (optional) receives the vertex count of the exact hull.
+ConvexHull BuildConvexHull(const std::vector<glm::vec3> &pts, int maxVertices, int *hullVertices = nullptr);
+
+// Hash identifying the input of BuildConvexHull (points and maxVertices), for the disk cache
+uint64_t HullSourceHash(const std::vector<glm::vec3> &pts, int maxVertices);
+// Hull cache file: returns false if it is missing, unreadable or was built from other input
+bool LoadHullCache(const std::string &path, uint64_t sourceHash, ConvexHull &hull);
+bool SaveHullCache(const std::string &path, uint64_t sourceHash, const ConvexHull &hull);
+
+// Placement of a hull in the world: p_world = pos + rot * (scale * p_model)
+struct HullPose
+{
+    const ConvexHull *hull = nullptr;
+    glm::mat3 rot = glm::mat3(1.0f);
+    glm::vec3 pos = glm::vec3(0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+// GJK boolean test between two placed hulls. Runs at most GJK_MAX_ITERATIONS iterations;
+// if it has not converged by then it reports an overlap (callers only run it after an
+// OBB test already passed, so that is the conservative answer). iterations (optional)
+// receives the number of iterations used.
+static constexpr int GJK_MAX_ITERATIONS = 32;
+bool GJKOverlap(const HullPose &a, const HullPose &b, int *iterations = nullptr);
@@ -0,0 +1,33 @@
+#include "CpuFeatures.h"
+
+#if HELLOGL_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures f;
+#if HELLOGL_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    f.sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avxBit = (info[2] & (1 << 28)) != 0;
+    // AVX also needs the OS to save YMM state on context switch
+    f.avx = osxsave && avxBit && ((_xgetbv(0) & 0x6) == 0x6);
+#else
+    __builtin_cpu_init();
+    f.sse2 = __builtin_cpu_supports("sse2");
+    f.avx = __builtin_cpu_supports("avx");
+#endif
+#endif
+    return f;
+}
+
+const CpuFeatures &GetCpuFeatures()
+{
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// Runtime CPU feature detection used to pick SIMD kernels.
+// On non-x86 targets every query returns false and callers fall back to scalar code.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HELLOGL_X86 1
+#else
+#define HELLOGL_X86 0
+#endif
+
+// Lets a single function use AVX intrinsics without compiling the whole file with -mavx.
+#if HELLOGL_X86 && (defined(__GNUC__) || defined(__clang__))
+#define HELLOGL_TARGET_AVX __attribute__((target("avx")))
+#else
+#define HELLOGL_TARGET_AVX
+#endif
+
+struct CpuFeatures
+{
+    bool sse2 = false;
+    bool avx = false;
+};
+
+// Detected once on first use; cheap to call afterwards.
+const CpuFeatures &GetCpuFeatures();
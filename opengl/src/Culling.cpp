@@ -0,0 +1,175 @@
+// src/Culling.cpp
+#include "Culling.h"
+#include "CpuFeatures.h"
+#include <cmath>
+
+#if HELLOGL_X86
+#include <immintrin.h>
+#endif
+
+Frustum FrustumFromMatrix(const glm::mat4 &m)
+{
+    // glm is column-major: row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&](int i)
+    { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+    glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    Frustum f;
+    f.planes[0] = r3 + r0;
+    f.planes[1] = r3 - r0;
+    f.planes[2] = r3 + r1;
+    f.planes[3] = r3 - r1;
+    f.planes[4] = r3 + r2;
+    f.planes[5] = r3 - r2;
+    for (glm::vec4 &p : f.planes)
+    {
+        float len = glm::length(glm::vec3(p));
+        if (len > 0.0f)
+            p /= len;
+    }
+    return f;
+}
+
+// Every kernel evaluates ((a*x + b*y) + c*z) + d < -r in this order (no FMA)
+bool SphereInFrustum(const Frustum &f, const glm::vec3 &c, float radius)
+{
+    for (const glm::vec4 &p : f.planes)
+    {
+        float d = ((p.x * c.x + p.y * c.y) + p.z * c.z) + p.w;
+        if (d < -radius)
+            return false;
+    }
+    return true;
+}
+
+bool AABBInFrustum(const Frustum &f, const AABB &box)
+{
+    for (const glm::vec4 &p : f.planes)
+    {
+        // corner farthest along the plane normal
+        glm::vec3 v(p.x >= 0.0f ? box.max.x : box.min.x,
+                    p.y >= 0.0f ? box.max.y : box.min.y,
+                    p.z >= 0.0f ? box.max.z : box.min.z);
+        if (((p.x * v.x + p.y * v.y) + p.z * v.z) + p.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+AABB TransformLocalBox(const LocalBox &box, const glm::mat4 &m)
+{
+    glm::vec3 c = glm::vec3(m * glm::vec4(box.center, 1.0f));
+    glm::vec3 e = glm::abs(glm::vec3(m[0])) * box.half.x +
+                  glm::abs(glm::vec3(m[1])) * box.half.y +
+                  glm::abs(glm::vec3(m[2])) * box.half.z;
+    return {c - e, c + e};
+}
+
+BoundingSphere TransformSphere(const BoundingSphere &sphere, const glm::mat4 &m)
+{
+    float s2 = glm::max(glm::dot(glm::vec3(m[0]), glm::vec3(m[0])),
+                        glm::max(glm::dot(glm::vec3(m[1]), glm::vec3(m[1])),
+                                 glm::dot(glm::vec3(m[2]), glm::vec3(m[2]))));
+    BoundingSphere out;
+    out.center = glm::vec3(m * glm::vec4(sphere.center, 1.0f));
+    out.radius = sphere.radius * std::sqrt(s2);
+    return out;
+}
+
+// ===== Batched sphere kernels =====
+
+static size_t CullScalar(const Frustum &f, const float *x, const float *y, const float *z, const float *r,
+                         size_t begin, size_t end, uint8_t *visible)
+{
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        bool in = SphereInFrustum(f, glm::vec3(x[i], y[i], z[i]), r[i]);
+        visible[i] = in ? 1 : 0;
+        count += in;
+    }
+    return count;
+}
+
+#if HELLOGL_X86
+static size_t CullSSE2(const Frustum &f, const float *x, const float *y, const float *z, const float *r,
+                       size_t n, uint8_t *visible)
+{
+    size_t count = 0;
+    size_t body = n & ~size_t(3);
+    for (size_t i = 0; i < body; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i), pz = _mm_loadu_ps(z + i);
+        __m128 nr = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(r + i));
+        __m128 out = _mm_setzero_ps();
+        for (const glm::vec4 &p : f.planes)
+        {
+            __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), px), _mm_mul_ps(_mm_set1_ps(p.y), py));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(p.z), pz));
+            d = _mm_add_ps(d, _mm_set1_ps(p.w));
+            out = _mm_or_ps(out, _mm_cmplt_ps(d, nr));
+        }
+        int culled = _mm_movemask_ps(out);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            uint8_t in = ((culled >> lane) & 1) ? 0 : 1;
+            visible[i + lane] = in;
+            count += in;
+        }
+    }
+    return count + CullScalar(f, x, y, z, r, body, n, visible);
+}
+
+HELLOGL_TARGET_AVX static size_t CullAVX(const Frustum &f, const float *x, const float *y, const float *z,
+                                         const float *r, size_t n, uint8_t *visible)
+{
+    size_t count = 0;
+    size_t body = n & ~size_t(7);
+    for (size_t i = 0; i < body; i += 8)
+    {
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i), pz = _mm256_loadu_ps(z + i);
+        __m256 nr = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(r + i));
+        __m256 out = _mm256_setzero_ps();
+        for (const glm::vec4 &p : f.planes)
+        {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.x), px), _mm256_mul_ps(_mm256_set1_ps(p.y), py));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(p.z), pz));
+            d = _mm256_add_ps(d, _mm256_set1_ps(p.w));
+            out = _mm256_or_ps(out, _mm256_cmp_ps(d, nr, _CMP_LT_OQ));
+        }
+        int culled = _mm256_movemask_ps(out);
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            uint8_t in = ((culled >> lane) & 1) ? 0 : 1;
+            visible[i + lane] = in;
+            count += in;
+        }
+    }
+    return count + CullScalar(f, x, y, z, r, body, n, visible);
+}
+#endif
+
+size_t CullSpheres(const Frustum &f, const float *x, const float *y, const float *z, const float *r,
+                   size_t n, uint8_t *visible)
+{
+#if HELLOGL_X86
+    const CpuFeatures &cpu = GetCpuFeatures();
+    if (cpu.avx)
+        return CullAVX(f, x, y, z, r, n, visible);
+    if (cpu.sse2)
+        return CullSSE2(f, x, y, z, r, n, visible);
+#endif
+    return CullScalar(f, x, y, z, r, 0, n, visible);
+}
+
+const char *CullKernelName()
+{
+#if HELLOGL_X86
+    const CpuFeatures &cpu = GetCpuFeatures();
+    if (cpu.avx)
+        return "avx";
+    if (cpu.sse2)
+        return "sse2";
+#endif
+    return "scalar";
+}
@@ -0,0 +1,50 @@
+// src/Culling.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Collision.h"
+
+// Clip volume of a view-projection matrix as six planes (dot(xyz, p) + w >= 0 inside,
+// xyz unit length). Works for perspective cameras and orthographic light volumes alike.
+struct Frustum
+{
+    glm::vec4 planes[6]; // left, right, bottom, top, near, far
+};
+
+// Gribb/Hartmann plane extraction from the rows of viewProj
+Frustum FrustumFromMatrix(const glm::mat4 &viewProj);
+
+bool SphereInFrustum(const Frustum &f, const glm::vec3 &center, float radius);
+// conservative: only boxes fully behind one plane are rejected
+bool AABBInFrustum(const Frustum &f, const AABB &box);
+
+// World AABB of a model-local box under a full model matrix (Arvo's method)
+AABB TransformLocalBox(const LocalBox &box, const glm::mat4 &model);
+// World sphere of a model-local sphere; the radius grows with the largest axis scale
+BoundingSphere TransformSphere(const BoundingSphere &sphere, const glm::mat4 &model);
+
+// Test n spheres in SoA layout against f; visible[i] = 1 if sphere i touches the frustum.
+// Returns the visible count. Dispatches to an AVX, SSE2 or scalar kernel at runtime;
+// all three do the same operations in the same order, so they agree with SphereInFrustum.
+size_t CullSpheres(const Frustum &f, const float *x, const float *y, const float *z, const float *r,
+                   size_t n, uint8_t *visible);
+// Name of the kernel CullSpheres will use on this CPU ("avx", "sse2" or "scalar")
+const char *CullKernelName();
+
+// Per-pass culling counters (tested = drawn + culled)
+struct CullStats
+{
+    uint32_t tested = 0;
+    uint32_t drawn = 0;
+    uint32_t culled = 0;
+
+    void Count(bool visible)
+    {
+        ++tested;
+        if (visible)
+            ++drawn;
+        else
+            ++culled;
+    }
+};
@@ -0,0 +1,212 @@
+// src/DrawList.cpp
+#include "DrawList.h"
+#include "StaticModel.h"
+#include <algorithm>
+
+static constexpr int DEPTH_BITS = 18;
+static constexpr uint32_t DEPTH_MAX = (1u << DEPTH_BITS) - 1;
+
+uint64_t DrawList::MakeKey(DrawPass pass, bool blended, GLuint program, GLuint texture,
+                           GLuint vao, uint32_t depth)
+{
+    uint64_t key = (uint64_t)(pass & 0xF) << 60;
+    if (!blended)
+    {
+        key |= (uint64_t)(program & 0xFF) << 50;
+        key |= (uint64_t)(texture & 0xFFFF) << 34;
+        key |= (uint64_t)(vao & 0xFFFF) << 18;
+        key |= depth;
+        return key;
+    }
+    // blended: back to front comes first, state only breaks ties
+    key |= (uint64_t)1 << 58;
+    key |= (uint64_t)(DEPTH_MAX - depth) << 40;
+    key |= (uint64_t)(program & 0xFF) << 32;
+    key |= (uint64_t)(texture & 0xFFFF) << 16;
+    key |= (uint64_t)(vao & 0xFFFF);
+    return key;
+}
+
+void DrawList::Clear()
+{
+    items.clear();
+    transforms.clear();
+    normalMats.clear();
+    stats = DrawListStats();
+}
+
+uint32_t DrawList::AddTransform(const glm::mat4 &model)
+{
+    transforms.push_back(model);
+    normalMats.push_back(glm::transpose(glm::inverse(glm::mat3(model))));
+    return (uint32_t)(transforms.size() - 1);
+}
+
+void DrawList::Add(DrawPass pass, const Shader &shader, const MeshRenderData &mesh,
+                   uint32_t transform, GLsizei instanceCount, float viewDepth)
+{
+    bool depthOnly = IsDepthOnlyPass(pass);
+    bool blended = !depthOnly && mesh.isHair;
+    GLuint texture = (!depthOnly && mesh.hasDiffuse) ? mesh.diffuseTex : 0;
+    float d = glm::clamp(viewDepth / maxDepth, 0.0f, 1.0f);
+    uint32_t depth = (uint32_t)(d * (float)DEPTH_MAX);
+
+    DrawItem item;
+    GLuint vao = depthOnly ? mesh.depthVao : mesh.vao;
+    item.key = MakeKey(pass, blended, shader.ID, texture, vao, depth);
+    item.shader = &shader;
+    item.mesh = &mesh;
+    item.instanceCount = instanceCount;
+    item.transform = transform;
+    items.push_back(item);
+}
+
+void DrawList::Sort()
+{
+    // LSD radix sort, 8 bits per pass; bytes every key shares are skipped
+    size_t n = items.size();
+    if (n < 2)
+        return;
+    scratch.resize(n);
+    DrawItem *src = items.data();
+    DrawItem *dst = scratch.data();
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t count[256] = {0};
+        for (size_t i = 0; i < n; ++i)
+            ++count[(src[i].key >> shift) & 0xFF];
+        if (count[(src[0].key >> shift) & 0xFF] == n)
+            continue;
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b)
+        {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i)
+            dst[count[(src[i].key >> shift) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+    if (src != items.data())
+        std::copy(src, src + n, items.data());
+}
+
+void DrawList::Execute(DrawPass pass)
+{
+    static const UniformId uModel = Shader::Id("uModel");
+    static const UniformId uNormalMat = Shader::Id("uNormalMat");
+    static const UniformId uInstanced = Shader::Id("uInstanced");
+    static const UniformId uHasDiffuse = Shader::Id("uHasDiffuse");
+    static const UniformId uHasAlpha = Shader::Id("uHasAlpha");
+    static const UniformId uUseAlphaTest = Shader::Id("uUseAlphaTest");
+    static const UniformId uAlphaCutoff = Shader::Id("uAlphaCutoff");
+    static const UniformId uMatDiffuse = Shader::Id("uMatDiffuse");
+    static const UniformId uDiffuseMap = Shader::Id("uDiffuseMap");
+    static const UniformId uPosScale = Shader::Id("uPosScale");
+    static const UniformId uPosOffset = Shader::Id("uPosOffset");
+
+    // items are sorted by pass, so this pass is one contiguous run
+    uint64_t passKey = (uint64_t)pass << 60;
+    auto first = std::lower_bound(items.begin(), items.end(), passKey,
+                                  [](const DrawItem &a, uint64_t k) { return a.key < k; });
+    bool depthOnly = IsDepthOnlyPass(pass);
+
+    // state is unknown at entry; the first item binds everything it needs
+    const Shader *curShader = nullptr;
+    GLuint curTex = UINT32_MAX;
+    GLuint curVAO = UINT32_MAX;
+    bool blending = false;
+    if (!depthOnly)
+        glActiveTexture(GL_TEXTURE0);
+
+    for (auto it = first; it != items.end() && (it->key >> 60) == pass; ++it)
+    {
+        const DrawItem &item = *it;
+        const MeshRenderData &m = *item.mesh;
+        const Shader &shader = *item.shader;
+        bool instanced = item.instanceCount > 0;
+        ++stats.items;
+
+        // what a full bind/unbind per mesh pays: program, VAO, texture, and blend on + off
+        stats.naiveStateChanges += 2;
+        if (!depthOnly)
+            stats.naiveStateChanges += 1 + (m.isHair ? 2 : 0);
+
+        if (&shader != curShader)
+        {
+            shader.use();
+            curShader = &shader;
+            ++stats.programBinds;
+        }
+        // per-draw uniforms; the shader's value cache drops the repeats
+        shader.setInt(uInstanced, instanced ? 1 : 0);
+        if (!instanced)
+        {
+            shader.setMat4(uModel, transforms[item.transform]);
+            if (!depthOnly)
+                shader.setMat3(uNormalMat, normalMats[item.transform]);
+        }
+        // positions may be quantized to the mesh bounds
+        shader.setVec3(uPosScale, m.positionDecode.scale);
+        shader.setVec3(uPosOffset, m.positionDecode.offset);
+
+        if (!depthOnly)
+        {
+            if (m.isHair != blending)
+            {
+                blending = m.isHair;
+                if (blending)
+                {
+                    glEnable(GL_BLEND);
+                    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    glDepthMask(GL_FALSE);
+                }
+                else
+                {
+                    glDepthMask(GL_TRUE);
+                    glDisable(GL_BLEND);
+                }
+                ++stats.blendChanges;
+            }
+
+            bool textured = m.hasDiffuse && m.diffuseTex;
+            shader.setVec3(uMatDiffuse, m.diffuseColor);
+            shader.setInt(uHasDiffuse, textured ? 1 : 0);
+            shader.setInt(uHasAlpha, m.hasAlpha ? 1 : 0);
+            shader.setInt(uUseAlphaTest, (m.hasAlpha || m.isHair) ? 1 : 0);
+            shader.setFloat(uAlphaCutoff, m.alphaCutoff);
+            shader.setInt(uDiffuseMap, 0);
+            GLuint tex = textured ? m.diffuseTex : 0;
+            if (tex != curTex)
+            {
+                glBindTexture(GL_TEXTURE_2D, tex);
+                curTex = tex;
+                ++stats.textureBinds;
+            }
+        }
+
+        GLuint vao = depthOnly ? m.depthVao : m.vao;
+        if (vao != curVAO)
+        {
+            glBindVertexArray(vao);
+            curVAO = vao;
+            ++stats.vaoBinds;
+        }
+        if (instanced)
+            glDrawElementsInstanced(GL_TRIANGLES, m.indexCount, m.indexType, 0, item.instanceCount);
+        else
+            glDrawElements(GL_TRIANGLES, m.indexCount, m.indexType, 0);
+    }
+
+    // restore state
+    if (blending)
+    {
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+    glBindVertexArray(0);
+    if (!depthOnly)
+        glBindTexture(GL_TEXTURE_2D, 0);
+    stats.stateChanges = stats.programBinds + stats.textureBinds + stats.vaoBinds + stats.blendChanges;
+}
@@ -0,0 +1,92 @@
+// src/DrawList.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+
+struct MeshRenderData;
+
+// The pass is the top field of the sort key; the renderer executes passes in whatever order it needs
+enum DrawPass : uint8_t
+{
+    // depth only, no material, texture or blend state: per shadow cascade, one pass of
+    // dynamic casters and one rebuilding its cached static layer
+    DRAW_PASS_SHADOW0 = 0,
+    DRAW_PASS_SHADOW1 = 1,
+    DRAW_PASS_SHADOW2 = 2,
+    DRAW_PASS_SHADOW3 = 3,
+    DRAW_PASS_STATIC_SHADOW0 = 4,
+    DRAW_PASS_STATIC_SHADOW1 = 5,
+    DRAW_PASS_STATIC_SHADOW2 = 6,
+    DRAW_PASS_STATIC_SHADOW3 = 7,
+    DRAW_PASS_MAIN = 8,
+};
+
+inline DrawPass ShadowPass(int cascade) { return (DrawPass)(DRAW_PASS_SHADOW0 + cascade); }
+inline DrawPass StaticShadowPass(int cascade) { return (DrawPass)(DRAW_PASS_STATIC_SHADOW0 + cascade); }
+inline bool IsDepthOnlyPass(DrawPass pass) { return pass < DRAW_PASS_MAIN; }
+
+// One mesh draw, queued for the frame. instanceCount = 0 is a single draw using
+// the list's transform at index transform; otherwise the mesh VAO's instance buffer is used
+// (the depth VAO's one in depth-only passes).
+struct DrawItem
+{
+    uint64_t key;
+    const Shader *shader;
+    const MeshRenderData *mesh;
+    GLsizei instanceCount;
+    uint32_t transform;
+};
+
+// Binds and state changes made by the last Execute calls, next to what drawing
+// every item with a full bind/unbind (the old per-model draw) would have made
+struct DrawListStats
+{
+    uint32_t items = 0;
+    uint32_t programBinds = 0;
+    uint32_t textureBinds = 0;
+    uint32_t vaoBinds = 0;
+    uint32_t blendChanges = 0;   // blend + depth-mask toggles
+    uint32_t stateChanges = 0;   // sum of the above
+    uint32_t naiveStateChanges = 0;
+    uint32_t Saved() const { return naiveStateChanges - stateChanges; }
+};
+
+// Frame draw list: passes submit items with a 64-bit key, Sort orders them with an LSD
+// radix sort and Execute walks one pass binding only what differs from the previous item.
+// Key, high to low: pass (4) | blend (2) | program (8) | texture (16) | VAO (16) | depth (18).
+// Opaque items come first, front to back; blended (hair/alpha) items follow, back to front,
+// with depth moved above the state fields so they still composite in order.
+// Buffers are kept between frames, so a steady frame doesn't allocate.
+class DrawList
+{
+public:
+    // view distance mapped onto the depth bits; farther items all share the last value
+    float maxDepth = 100.0f;
+
+    void Clear();
+    // World transform for single draws; also stores its normal matrix. Returns its index.
+    uint32_t AddTransform(const glm::mat4 &model);
+    void Add(DrawPass pass, const Shader &shader, const MeshRenderData &mesh,
+             uint32_t transform, GLsizei instanceCount, float viewDepth);
+    void Sort();
+    // Issue the sorted items of one pass (the caller sets up framebuffer/viewport)
+    void Execute(DrawPass pass);
+
+    const glm::mat4 &Transform(uint32_t i) const { return transforms[i]; }
+    size_t size() const { return items.size(); }
+    const DrawListStats &Stats() const { return stats; }
+
+private:
+    std::vector<DrawItem> items;
+    std::vector<DrawItem> scratch;
+    std::vector<glm::mat4> transforms;
+    std::vector<glm::mat3> normalMats;
+    DrawListStats stats;
+
+    static uint64_t MakeKey(DrawPass pass, bool blended, GLuint program, GLuint texture,
+                            GLuint vao, uint32_t depth);
+};
@@ -0,0 +1,273 @@
+#include "FallingSet.h"
+#include "CpuFeatures.h"
+#include "Transform.h"
+#include <cmath>
+#include <algorithm>
+
+#if HELLOGL_X86
+#include <immintrin.h>
+#endif
+
+void FallingSet::SetCapacity(size_t n)
+{
+    ForEachArray([&](auto &a)
+                 {
+                     a.clear();
+                     a.shrink_to_fit();
+                     a.reserve(n);
+                 });
+    slots.assign(n, Slot{0, 0});
+    clear();
+}
+
+void FallingSet::clear()
+{
+    ForEachArray([](auto &a)
+                 { a.clear(); });
+    // rebuild the free list in slot order so a cleared pool hands out slots 0, 1, 2...
+    const uint32_t n = (uint32_t)slots.size();
+    for (uint32_t s = 0; s < n; ++s)
+    {
+        slots[s].dense = (s + 1 < n) ? s + 1 : UINT32_MAX;
+        slots[s].generation++;
+    }
+    freeHead = n ? 0 : UINT32_MAX;
+}
+
+FallingHandle FallingSet::Add(const Falling &f)
+{
+    if (freeHead == UINT32_MAX)
+        return FallingHandle();
+
+    uint32_t slot = freeHead;
+    freeHead = slots[slot].dense;
+    slots[slot].dense = (uint32_t)size();
+    denseToSlot.push_back(slot);
+
+    posX.push_back(f.pos.x); posY.push_back(f.pos.y); posZ.push_back(f.pos.z);
+    velX.push_back(f.vel.x); velY.push_back(f.vel.y); velZ.push_back(f.vel.z);
+    glm::quat q = glm::angleAxis(f.rot, f.rotAxis);
+    glm::vec3 spin = f.rotAxis * f.rotSpeed;
+    qx.push_back(q.x); qy.push_back(q.y); qz.push_back(q.z); qw.push_back(q.w);
+    spinX.push_back(spin.x); spinY.push_back(spin.y); spinZ.push_back(spin.z);
+    prevX.push_back(f.pos.x); prevY.push_back(f.pos.y); prevZ.push_back(f.pos.z);
+    prevQx.push_back(q.x); prevQy.push_back(q.y); prevQz.push_back(q.z); prevQw.push_back(q.w);
+    modelScale.push_back(f.modelScale);
+    color.push_back(f.color);
+    modelMatrix.push_back(glm::mat4(1.0f));
+    modelIndex.push_back(f.modelIndex);
+    alive.push_back(1);
+    sepAxis.push_back(-1);
+    phase.push_back(FALL_NEAR_FLOOR);
+
+    return {slot, slots[slot].generation};
+}
+
+void FallingSet::Remove(size_t i)
+{
+    uint32_t slot = denseToSlot[i];
+    size_t last = size() - 1;
+    if (i != last)
+    {
+        ForEachArray([&](auto &a)
+                     { a[i] = a[last]; });
+        slots[denseToSlot[i]].dense = (uint32_t)i;
+    }
+    ForEachArray([](auto &a)
+                 { a.pop_back(); });
+
+    slots[slot].generation++;
+    slots[slot].dense = freeHead;
+    freeHead = slot;
+}
+
+void FallingSet::RemoveDead()
+{
+    // walk backwards so every object swapped into a hole has already been checked
+    for (size_t i = size(); i-- > 0;)
+    {
+        if (!alive[i])
+            Remove(i);
+    }
+}
+
+size_t FallingSet::Find(FallingHandle h) const
+{
+    if (h.slot >= slots.size() || slots[h.slot].generation != h.generation)
+        return SIZE_MAX;
+    return slots[h.slot].dense;
+}
+
+void FallingSet::SaveState()
+{
+    std::copy(posX.begin(), posX.end(), prevX.begin());
+    std::copy(posY.begin(), posY.end(), prevY.begin());
+    std::copy(posZ.begin(), posZ.end(), prevZ.begin());
+    std::copy(qx.begin(), qx.end(), prevQx.begin());
+    std::copy(qy.begin(), qy.end(), prevQy.begin());
+    std::copy(qz.begin(), qz.end(), prevQz.begin());
+    std::copy(qw.begin(), qw.end(), prevQw.begin());
+}
+
+glm::mat4 FallingSet::InterpolatedMatrix(size_t i, float alpha) const
+{
+    glm::vec3 p = glm::mix(PrevPos(i), Pos(i), alpha);
+    glm::quat q = QuatNlerp(PrevOrientation(i), Orientation(i), alpha);
+    return ComposeTRS(p, QuatToMat3(q), modelScale[i]);
+}
+
+// ===== Integration kernels =====
+// All kernels do the same IEEE operations in the same order (no FMA), so they agree bit for bit.
+// Orientation uses the first-order update q' = q + h * (w, 0) * q with h = dt/2, then
+// renormalizes with sqrt + divide (exact in every kernel, unlike rsqrt estimates).
+
+static void IntegrateScalar(FallingSet &s, size_t begin, size_t end, float dt, float dv)
+{
+    const float h = 0.5f * dt;
+    for (size_t i = begin; i < end; ++i)
+    {
+        s.velY[i] += dv;
+        s.posX[i] += s.velX[i] * dt;
+        s.posY[i] += s.velY[i] * dt;
+        s.posZ[i] += s.velZ[i] * dt;
+
+        float x = s.qx[i], y = s.qy[i], z = s.qz[i], w = s.qw[i];
+        float wx = s.spinX[i], wy = s.spinY[i], wz = s.spinZ[i];
+        float nx = x + h * ((w * wx + wy * z) - wz * y);
+        float ny = y + h * ((w * wy + wz * x) - wx * z);
+        float nz = z + h * ((w * wz + wx * y) - wy * x);
+        float nw = w - h * ((wx * x + wy * y) + wz * z);
+        float len = std::sqrt(((nx * nx + ny * ny) + nz * nz) + nw * nw);
+        s.qx[i] = nx / len;
+        s.qy[i] = ny / len;
+        s.qz[i] = nz / len;
+        s.qw[i] = nw / len;
+    }
+}
+
+#if HELLOGL_X86
+// SIMD kernels take [begin, end); a scalar head runs until the index is 32-byte aligned
+static void IntegrateSSE2(FallingSet &s, size_t begin, size_t end, float dt, float dv)
+{
+    size_t head = std::min(end, (begin + 7) & ~size_t(7));
+    IntegrateScalar(s, begin, head, dt, dv);
+    const size_t n4 = head + ((end - head) & ~size_t(3));
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdv = _mm_set1_ps(dv);
+    const __m128 vh = _mm_set1_ps(0.5f * dt);
+    for (size_t i = head; i < n4; i += 4)
+    {
+        __m128 vy = _mm_add_ps(_mm_load_ps(&s.velY[i]), vdv);
+        _mm_store_ps(&s.velY[i], vy);
+        _mm_store_ps(&s.posX[i], _mm_add_ps(_mm_load_ps(&s.posX[i]), _mm_mul_ps(_mm_load_ps(&s.velX[i]), vdt)));
+        _mm_store_ps(&s.posY[i], _mm_add_ps(_mm_load_ps(&s.posY[i]), _mm_mul_ps(vy, vdt)));
+        _mm_store_ps(&s.posZ[i], _mm_add_ps(_mm_load_ps(&s.posZ[i]), _mm_mul_ps(_mm_load_ps(&s.velZ[i]), vdt)));
+
+        __m128 x = _mm_load_ps(&s.qx[i]), y = _mm_load_ps(&s.qy[i]);
+        __m128 z = _mm_load_ps(&s.qz[i]), w = _mm_load_ps(&s.qw[i]);
+        __m128 wx = _mm_load_ps(&s.spinX[i]), wy = _mm_load_ps(&s.spinY[i]), wz = _mm_load_ps(&s.spinZ[i]);
+        __m128 nx = _mm_add_ps(x, _mm_mul_ps(vh, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(w, wx), _mm_mul_ps(wy, z)), _mm_mul_ps(wz, y))));
+        __m128 ny = _mm_add_ps(y, _mm_mul_ps(vh, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(w, wy), _mm_mul_ps(wz, x)), _mm_mul_ps(wx, z))));
+        __m128 nz = _mm_add_ps(z, _mm_mul_ps(vh, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(w, wz), _mm_mul_ps(wx, y)), _mm_mul_ps(wy, x))));
+        __m128 nw = _mm_sub_ps(w, _mm_mul_ps(vh, _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, x), _mm_mul_ps(wy, y)), _mm_mul_ps(wz, z))));
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)), _mm_mul_ps(nw, nw)));
+        _mm_store_ps(&s.qx[i], _mm_div_ps(nx, len));
+        _mm_store_ps(&s.qy[i], _mm_div_ps(ny, len));
+        _mm_store_ps(&s.qz[i], _mm_div_ps(nz, len));
+        _mm_store_ps(&s.qw[i], _mm_div_ps(nw, len));
+    }
+    IntegrateScalar(s, n4, end, dt, dv);
+}
+
+HELLOGL_TARGET_AVX static void IntegrateAVX(FallingSet &s, size_t begin, size_t end, float dt, float dv)
+{
+    size_t head = std::min(end, (begin + 7) & ~size_t(7));
+    IntegrateScalar(s, begin, head, dt, dv);
+    const size_t n8 = head + ((end - head) & ~size_t(7));
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vdv = _mm256_set1_ps(dv);
+    const __m256 vh = _mm256_set1_ps(0.5f * dt);
+    for (size_t i = head; i < n8; i += 8)
+    {
+        __m256 vy = _mm256_add_ps(_mm256_load_ps(&s.velY[i]), vdv);
+        _mm256_store_ps(&s.velY[i], vy);
+        _mm256_store_ps(&s.posX[i], _mm256_add_ps(_mm256_load_ps(&s.posX[i]), _mm256_mul_ps(_mm256_load_ps(&s.velX[i]), vdt)));
+        _mm256_store_ps(&s.posY[i], _mm256_add_ps(_mm256_load_ps(&s.posY[i]), _mm256_mul_ps(vy, vdt)));
+        _mm256_store_ps(&s.posZ[i], _mm256_add_ps(_mm256_load_ps(&s.posZ[i]), _mm256_mul_ps(_mm256_load_ps(&s.velZ[i]), vdt)));
+
+        __m256 x = _mm256_load_ps(&s.qx[i]), y = _mm256_load_ps(&s.qy[i]);
+        __m256 z = _mm256_load_ps(&s.qz[i]), w = _mm256_load_ps(&s.qw[i]);
+        __m256 wx = _mm256_load_ps(&s.spinX[i]), wy = _mm256_load_ps(&s.spinY[i]), wz = _mm256_load_ps(&s.spinZ[i]);
+        __m256 nx = _mm256_add_ps(x, _mm256_mul_ps(vh, _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(w, wx), _mm256_mul_ps(wy, z)), _mm256_mul_ps(wz, y))));
+        __m256 ny = _mm256_add_ps(y, _mm256_mul_ps(vh, _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(w, wy), _mm256_mul_ps(wz, x)), _mm256_mul_ps(wx, z))));
+        __m256 nz = _mm256_add_ps(z, _mm256_mul_ps(vh, _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(w, wz), _mm256_mul_ps(wx, y)), _mm256_mul_ps(wy, x))));
+        __m256 nw = _mm256_sub_ps(w, _mm256_mul_ps(vh, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(wx, x), _mm256_mul_ps(wy, y)), _mm256_mul_ps(wz, z))));
+        __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz)), _mm256_mul_ps(nw, nw)));
+        _mm256_store_ps(&s.qx[i], _mm256_div_ps(nx, len));
+        _mm256_store_ps(&s.qy[i], _mm256_div_ps(ny, len));
+        _mm256_store_ps(&s.qz[i], _mm256_div_ps(nz, len));
+        _mm256_store_ps(&s.qw[i], _mm256_div_ps(nw, len));
+    }
+    IntegrateScalar(s, n8, end, dt, dv);
+}
+#endif
+
+enum class FallingKernel
+{
+    Scalar,
+    SSE2,
+    AVX
+};
+
+static FallingKernel SelectFallingKernel()
+{
+    const CpuFeatures &cpu = GetCpuFeatures();
+    if (cpu.avx)
+        return FallingKernel::AVX;
+    if (cpu.sse2)
+        return FallingKernel::SSE2;
+    return FallingKernel::Scalar;
+}
+
+static FallingKernel ActiveFallingKernel()
+{
+    static const FallingKernel kernel = SelectFallingKernel();
+    return kernel;
+}
+
+void IntegrateFalling(FallingSet &set, float dt, float gravity)
+{
+    IntegrateFalling(set, 0, set.size(), dt, gravity);
+}
+
+void IntegrateFalling(FallingSet &set, size_t begin, size_t end, float dt, float gravity)
+{
+    const float dv = gravity * dt;
+    switch (ActiveFallingKernel())
+    {
+#if HELLOGL_X86
+    case FallingKernel::AVX:
+        IntegrateAVX(set, begin, end, dt, dv);
+        break;
+    case FallingKernel::SSE2:
+        IntegrateSSE2(set, begin, end, dt, dv);
+        break;
+#endif
+    default:
+        IntegrateScalar(set, begin, end, dt, dv);
+        break;
+    }
+}
+
+const char *FallingKernelName()
+{
+    switch (ActiveFallingKernel())
+    {
+    case FallingKernel::AVX:
+        return "avx";
+    case FallingKernel::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
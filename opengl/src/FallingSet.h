@@ -0,0 +1,180 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Spawn description of a falling object (AoS, used only when adding to a FallingSet)
+struct Falling
+{
+    glm::vec3 pos;
+    glm::vec3 vel;
+    glm::vec3 color;
+    float rot;            // initial rotation angle (radians) about rotAxis
+    glm::vec3 rotAxis;    // rotation axis (unit length)
+    float rotSpeed;       // radians per second about rotAxis
+    glm::vec3 modelScale; // instance scale
+    int modelIndex;       // which model to use (if multiple)
+};
+
+// How much collision work a falling object needs, raised by Game's landing timers as the
+// lowest point the object could have comes down past the player's reach and then the floor
+enum FallPhase : uint8_t
+{
+    FALL_CLEAR = 0,       // out of the player's reach: integrate only
+    FALL_NEAR_PLAYER = 1, // player tests
+    FALL_NEAR_FLOOR = 2   // player tests and floor contact
+};
+
+// std::vector allocator returning Align-byte aligned storage (for aligned SIMD loads)
+template <typename T, std::size_t Align>
+struct AlignedAllocator
+{
+    using value_type = T;
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> &) {}
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T *p, std::size_t)
+    {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align> &) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align> &) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T, 32>>;
+
+// Stable reference to a falling object; survives other objects being removed.
+// A handle whose object was removed (and whose slot may be reused) no longer resolves.
+struct FallingHandle
+{
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+    bool valid() const { return slot != UINT32_MAX; }
+};
+
+// Fixed-capacity pool of falling objects stored as structure-of-arrays.
+// Hot fields touched by the integrator every tick are split into 32-byte aligned float
+// arrays; cold per-object data (render tint, cached matrix, model choice) lives apart.
+// Live objects are always dense in [0, size()); removal swaps the last object into the
+// hole, and a free list of slots keeps handles stable. All storage is reserved up front,
+// so Add/Remove never touch the heap.
+class FallingSet
+{
+public:
+    // ---- hot: integrated every tick ----
+    AlignedVector<float> posX, posY, posZ;
+    AlignedVector<float> velX, velY, velZ;
+    AlignedVector<float> qx, qy, qz, qw;       // orientation (unit quaternion)
+    AlignedVector<float> spinX, spinY, spinZ; // angular velocity (axis * radians per second)
+    // state at the start of the current tick, for render interpolation
+    AlignedVector<float> prevX, prevY, prevZ;
+    AlignedVector<float> prevQx, prevQy, prevQz, prevQw;
+
+    // ---- cold ----
+    std::vector<glm::vec3> modelScale;
+    std::vector<glm::vec3> color;
+    std::vector<glm::mat4> modelMatrix;
+    std::vector<int> modelIndex;
+    std::vector<uint8_t> alive;
+    // axis that separated this object from the player at its last narrowphase test
+    // (OBBSeparatingAxis numbering, -1 = none); tried first next time
+    std::vector<int8_t> sepAxis;
+    std::vector<uint8_t> phase; // FallPhase; new objects start at FALL_NEAR_FLOOR (test everything)
+
+    explicit FallingSet(size_t capacity = 0) { SetCapacity(capacity); }
+
+    // Reserve storage for n objects; drops all live objects
+    void SetCapacity(size_t n);
+    size_t capacity() const { return slots.size(); }
+    size_t size() const { return posX.size(); }
+    bool empty() const { return posX.empty(); }
+    bool full() const { return size() >= capacity(); }
+    void clear();
+
+    // Returns an invalid handle (and adds nothing) when the pool is full
+    FallingHandle Add(const Falling &f);
+    // O(1): moves the last object into dense index i
+    void Remove(size_t i);
+    // remove every object whose alive flag was cleared
+    void RemoveDead();
+
+    FallingHandle HandleAt(size_t i) const { return {denseToSlot[i], slots[denseToSlot[i]].generation}; }
+    // dense index of a live handle, or SIZE_MAX if it was removed
+    size_t Find(FallingHandle h) const;
+
+    // copy current position/orientation into the prev* arrays (call at the start of a tick)
+    void SaveState();
+    // world matrix blended between the previous and current tick (alpha in [0,1])
+    glm::mat4 InterpolatedMatrix(size_t i, float alpha) const;
+
+    glm::vec3 Pos(size_t i) const { return glm::vec3(posX[i], posY[i], posZ[i]); }
+    void SetPos(size_t i, const glm::vec3 &p)
+    {
+        posX[i] = p.x;
+        posY[i] = p.y;
+        posZ[i] = p.z;
+    }
+    // position at the start of the current tick (as saved by SaveState)
+    glm::vec3 PrevPos(size_t i) const { return glm::vec3(prevX[i], prevY[i], prevZ[i]); }
+    glm::quat Orientation(size_t i) const { return glm::quat(qw[i], qx[i], qy[i], qz[i]); }
+    glm::quat PrevOrientation(size_t i) const { return glm::quat(prevQw[i], prevQx[i], prevQy[i], prevQz[i]); }
+    glm::vec3 Vel(size_t i) const { return glm::vec3(velX[i], velY[i], velZ[i]); }
+    void SetVel(size_t i, const glm::vec3 &v)
+    {
+        velX[i] = v.x;
+        velY[i] = v.y;
+        velZ[i] = v.z;
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t dense;      // dense index while live, next free slot while free
+        uint32_t generation; // bumped on every removal
+    };
+    std::vector<Slot> slots;
+    std::vector<uint32_t> denseToSlot;
+    uint32_t freeHead = UINT32_MAX;
+
+    // apply f to every per-object array (hot, cold and the dense->slot map)
+    template <typename F>
+    void ForEachArray(F &&f)
+    {
+        f(posX); f(posY); f(posZ);
+        f(velX); f(velY); f(velZ);
+        f(qx); f(qy); f(qz); f(qw);
+        f(spinX); f(spinY); f(spinZ);
+        f(prevX); f(prevY); f(prevZ);
+        f(prevQx); f(prevQy); f(prevQz); f(prevQw);
+        f(modelScale); f(color);
+        f(modelMatrix); f(modelIndex); f(alive); f(sepAxis); f(phase);
+        f(denseToSlot);
+    }
+};
+
+// Integrate velocity (constant downward acceleration), position and orientation for
+// every object: vel.y += gravity*dt, pos += vel*dt, q += dt/2 * (spin, 0) * q, renormalized.
+// Dispatches at runtime to an AVX, SSE2 or scalar kernel; all three give identical results.
+void IntegrateFalling(FallingSet &set, float dt, float gravity);
+// Same, restricted to objects [begin, end) so chunks can be integrated on different threads
+void IntegrateFalling(FallingSet &set, size_t begin, size_t end, float dt, float gravity);
+// Name of the kernel IntegrateFalling will use on this CPU ("avx", "sse2" or "scalar")
+const char *FallingKernelName();
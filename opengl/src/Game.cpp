@@ -1,121 +1,20 @@
 #include "Game.h"
+#include "MemStats.h"
+#include "Collision.h"
+#include "Transform.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include <glad/glad.h>
 #include <cstdlib>
 #include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <random>
+#include <cmath>
 
 // File-scope: store the player's fixed Y height so we can force horizontal-only motion
 static float s_playerFixedY = 0.5f;
 
-// put near top of Game.cpp or in Collision.h
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <cmath>
-
-struct OBB
-{
-    glm::vec3 center;  // world-space center
-    glm::vec3 axis[3]; // orthonormal axes in world space (unit vectors)
-    float half[3];     // half-lengths along each axis (world units)
-};
-// modelMatrix 是实例的完整世界变换矩阵 (translate*rotate*scale)
-// bboxMin/max are in model-local coordinates
-static OBB BuildOBBFromModel(const glm::vec3 &bboxMin,
-                             const glm::vec3 &bboxMax,
-                             const glm::mat4 &modelMatrix)
-{
-    // local center and half extents
-    glm::vec3 localCenter = (bboxMin + bboxMax) * 0.5f;
-    glm::vec3 localHalf = (bboxMax - bboxMin) * 0.5f;
-
-    // world center
-    glm::vec3 worldCenter = glm::vec3(modelMatrix * glm::vec4(localCenter, 1.0f));
-
-    // linear 3x3 part (rotation * scale)
-    glm::mat3 M3 = glm::mat3(modelMatrix);
-
-    OBB obb;
-    obb.center = worldCenter;
-
-    // for each local axis (unit vectors X,Y,Z), transform by M3:
-    // axis vector in world = normalize(M3 * unit)
-    // half-length in world = length(M3 * unit) * localHalf[i]
-    glm::vec3 ux = glm::vec3(M3 * glm::vec3(1.0f, 0.0f, 0.0f));
-    glm::vec3 uy = glm::vec3(M3 * glm::vec3(0.0f, 1.0f, 0.0f));
-    glm::vec3 uz = glm::vec3(M3 * glm::vec3(0.0f, 0.0f, 1.0f));
-
-    float lenx = glm::length(ux);
-    float leny = glm::length(uy);
-    float lenz = glm::length(uz);
-
-    // Avoid degenerate axes
-    obb.axis[0] = (lenx > 1e-6f) ? ux / lenx : glm::vec3(1, 0, 0);
-    obb.axis[1] = (leny > 1e-6f) ? uy / leny : glm::vec3(0, 1, 0);
-    obb.axis[2] = (lenz > 1e-6f) ? uz / lenz : glm::vec3(0, 0, 1);
-
-    obb.half[0] = lenx * localHalf.x;
-    obb.half[1] = leny * localHalf.y;
-    obb.half[2] = lenz * localHalf.z;
-
-    return obb;
-}
-// returns true if obbA and obbB overlap
-static bool OBBIntersectSAT(const OBB &A, const OBB &B)
-{
-    // vector from A to B
-    glm::vec3 T = B.center - A.center;
-
-    // list of 15 test axes: A.axis[0..2], B.axis[0..2], and cross products
-    // we will test each axis by projecting both boxes onto it
-
-    // convenience lambdas
-    auto projectIntervalRadius = [](const OBB &O, const glm::vec3 &axis) -> float
-    {
-        // axis assumed unit length
-        float r = 0.0f;
-        r += O.half[0] * fabs(glm::dot(O.axis[0], axis));
-        r += O.half[1] * fabs(glm::dot(O.axis[1], axis));
-        r += O.half[2] * fabs(glm::dot(O.axis[2], axis));
-        return r;
-    };
-
-    // test function for an axis (must be normalized)
-    auto testAxis = [&](const glm::vec3 &axis) -> bool
-    {
-        float axisLen2 = glm::dot(axis, axis);
-        if (axisLen2 < 1e-8f)
-            return true; // axis degenerate -> skip test (treat as non-separating)
-        glm::vec3 axisN = axis / (float)sqrt(axisLen2);
-        float dist = fabs(glm::dot(T, axisN));
-        float ra = projectIntervalRadius(A, axisN);
-        float rb = projectIntervalRadius(B, axisN);
-        return dist <= (ra + rb) + 1e-6f; // overlap if true
-    };
-
-    // 3 axes A
-    for (int i = 0; i < 3; i++)
-        if (!testAxis(A.axis[i]))
-            return false;
-    // 3 axes B
-    for (int i = 0; i < 3; i++)
-        if (!testAxis(B.axis[i]))
-            return false;
-    // 9 cross axes
-    for (int i = 0; i < 3; i++)
-    {
-        for (int j = 0; j < 3; j++)
-        {
-            glm::vec3 ax = glm::cross(A.axis[i], B.axis[j]);
-            if (!testAxis(ax))
-                return false;
-        }
-    }
-    // no separating axis found -> intersection
-    return true;
-}
+// gravity for falling objects and landed props (slowed down for gameplay)
+static const float FALL_GRAVITY = -9.8f * 0.2f;
 
 // safe absolute dot
 static inline float AbsDot(const glm::vec3 &a, const glm::vec3 &b)
@@ -128,38 +27,22 @@ struct FallingObjectConfig
     std::string path;
     glm::vec3 modelScale;
 };
-glm::vec3 sunDir = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.2f));
-
-glm::mat4 lightView = glm::lookAt(
-    -sunDir * 10.0f,
-    glm::vec3(0.0f),
-    glm::vec3(0, 1, 0));
-
-glm::mat4 lightProj = glm::ortho(
-    -10.0f, 10.0f,
-    -10.0f, 10.0f,
-    1.0f, 30.0f);
-
-glm::mat4 lightVP = lightProj * lightView;
-static glm::mat4 MakeModelMatrix(const glm::vec3 &position,
-                                 const glm::vec3 &rotAxis, float rotAngleRad,
-                                 const glm::vec3 &scale)
+// player model faces the camera: fixed 180 degree turn about +Y
+static const glm::mat3 &PlayerRotation()
 {
-    glm::mat4 m(1.0f);
-    m = glm::translate(m, position);
-    if (rotAngleRad != 0.0f)
-        m = glm::rotate(m, rotAngleRad, rotAxis);
-    m = glm::scale(m, scale);
-    return m;
+    static const glm::mat3 r = QuatToMat3(glm::angleAxis(glm::radians(180.0f), glm::vec3(0, 1, 0)));
+    return r;
 }
 
 Game::Game()
-    : spawnTimer(0.0f), playerDead(false)
+    : falling(MAX_FALLING), props(MAX_PROPS), spawnTimer(0.0f), playerDead(false),
+      fallTimers((uint32_t)MAX_FALLING)
 {
     // seed RNG with high-resolution clock
-    rng.seed((uint32_t)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    seed = (uint32_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    rng.seed(seed);
 }
-bool Game::LoadResources(const std::string &assetsDir)
+bool Game::LoadResources(const std::string &assetsDir, bool keepGeometry)
 {
     FallingObjectConfig fallingModelsConfig[3] = {
         {assetsDir + "/models/bucket.obj", glm::vec3(0.2f)},
@@ -170,14 +53,14 @@ bool Game::LoadResources(const std::string &assetsDir)
     for (int i = 0; i < 3; ++i)
     {
         fallingModels[i].modelScale = fallingModelsConfig[i].modelScale;
-        ok &= fallingModels[i].LoadFromFile(fallingModelsConfig[i].path);
+        ok &= fallingModels[i].LoadFromFile(fallingModelsConfig[i].path, keepGeometry);
         if (!ok)
         {
             std::cerr << "Failed load falling objects: " << fallingModelsConfig[i].path << std::endl;
         }
     }
     std::string floorPath = assetsDir + "/models/floor.obj";
-    ok &= floorModel.LoadFromFile(floorPath);
+    ok &= floorModel.LoadFromFile(floorPath, keepGeometry);
     if (!ok)
     {
         std::cerr << "Failed load floor: " << floorPath << std::endl;
@@ -200,42 +83,34 @@ bool Game::LoadResources(const std::string &assetsDir)
     return ok;
 }
 
-void Game::InitShadowMap()
-{
-    // ===== Shadow map framebuffer =====
-    glGenFramebuffers(1, &depthFBO);
-
-    // depth texture
-    glGenTextures(1, &depthMap);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
-                 SHADOW_SIZE, SHADOW_SIZE, 0,
-                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-
-    float borderColor[] = {1.0, 1.0, 1.0, 1.0};
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-    // attach
-    glBindFramebuffer(GL_FRAMEBUFFER, depthFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                           GL_TEXTURE_2D, depthMap, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
 void Game::Reset()
 {
+    // every run starts from a known seed so it can be recorded and replayed
+    if (!fixedSeed)
+        seed = (uint32_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    rng.seed(seed);
+
     falling.clear();
+    props.clear();
     spawnTimer = 0.0f;
 
+    // size per-tick scratch for a full pool so Update never has to grow it
+    size_t chunkSize = std::max<size_t>((parallelChunkSize + 7) & ~size_t(7), 8);
+    stepResults.resize((MAX_FALLING + chunkSize - 1) / chunkSize);
+    for (auto &r : stepResults)
+        r.landed.reserve(chunkSize);
+    stepResults[0].landed.reserve(MAX_FALLING); // the serial path runs everything as chunk 0
+    landedThisTick.reserve(MAX_FALLING);
+    fallTimers.Clear();
+    firedTimers.reserve(MAX_FALLING);
+    timerDt = 0.0f;
+
     // Player stands at 0.5 height
     player.groundY = 0.5f;
     player.pos = glm::vec3(0.0f, player.groundY, 0.0f);
+    player.prevPos = player.pos;
+    accumulator = 0.0f;
+    renderAlpha = 1.0f;
 
     player.color = glm::vec3(1.0f, 0.8f, 0.1f);
     playerDead = false;
@@ -251,7 +126,7 @@ void Game::Reset()
 
     // set floor modelMatrix once
     glm::vec3 floorPos(0.0f, floorYOffset, 0.0f);
-    floorModel.modelMatrix = MakeModelMatrix(floorPos, glm::vec3(0, 1, 0), 0.0f, floorModel.modelScale);
+    floorModel.modelMatrix = ComposeTRS(floorPos, glm::mat3(1.0f), floorModel.modelScale);
 }
 
 static float randf(std::mt19937 &rng, float a, float b)
@@ -260,7 +135,7 @@ static float randf(std::mt19937 &rng, float a, float b)
     return d(rng);
 }
 
-void Game::SpawnObject()
+FallingHandle Game::SpawnObject()
 {
     Falling f;
     f.pos.x = randf(rng, -4.0f, 4.0f);
@@ -278,311 +153,508 @@ void Game::SpawnObject()
         ax = glm::vec3(0.0f, 1.0f, 0.0f);
     f.rotAxis = glm::normalize(ax);
     f.rotSpeed = randf(rng, 1.0f, 2.0f);
-    f.alive = true;
 
     f.modelIndex = rng() % 3; // pick which model to use
-    // compute instance AABB half extents in model-space then in world
     f.modelScale = fallingModels[f.modelIndex].modelScale;
-    f.halfExtents = 0.5f * (fallingModels[f.modelIndex].bboxMax - fallingModels[f.modelIndex].bboxMin);
 
     // optional color multiplier (for tinting)
     f.color = glm::vec3(randf(rng, 0.6f, 1.0f), randf(rng, 0.1f, 0.6f), randf(rng, 0.1f, 0.9f));
 
-    falling.push_back(f);
+    return falling.Add(f); // dropped if the pool is full
 }
-void Game::Update(float dt, const bool keys[1024], const glm::vec3 &cameraFront, const glm::vec3 &cameraUp)
-{
-    if (playerDead)
-        return;
 
-    const float floorTop = -0.5f;
-    player.Update(dt, keys, cameraFront, cameraUp);
-
-    const float floorHalf = 12.0f * 0.5f; // = 6.0f
+// Number of ticks before an object at height y, moving at vy, can come down to height h:
+// the same semi-implicit Euler steps IntegrateFalling takes, y_k = y + dt*(k*vy + g*dt*k(k+1)/2),
+// solved for the first step k with y_k <= h. The object needs testing during step k, which
+// runs k - 1 ticks from now; one more tick is taken off to absorb rounding.
+static uint64_t TicksToHeight(float y, float vy, float h, float g, float dt)
+{
+    double a = 0.5 * g * dt * dt, b = vy * dt + a, c = y - h;
+    if (c <= 0.0 || a >= 0.0)
+        return 0;
+    double k = (-b - std::sqrt(b * b - 4.0 * a * c)) / (2.0 * a);
+    return (uint64_t)std::max(std::ceil(k) - 2.0, 0.0);
+}
 
-    // Player radius (0.6 scaled cube)
-    const float playerHalf = 0.3f;
+// Put object i in the phase its current state allows and set a timer for the next one.
+// Thresholds use the lowest point the object could have in any orientation, so an object
+// is never left out of a test it would have passed.
+void Game::ArmFalling(size_t i, float dt, float reachTop)
+{
+    const ModelCollision &col = fallingModels[falling.modelIndex[i]].collision;
+    const glm::vec3 &scale = falling.modelScale[i];
+    const float EPS = 1e-4f; // same floor tolerance as StepFallingRange
+    float maxScale = std::max({std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z)});
+    float boxDrop = glm::length(col.box.center * scale) + col.box.half.y * std::fabs(scale.y);
+    float sphereDrop = glm::length(col.sphere.center * scale) + col.sphere.radius * maxScale;
+
+    uint64_t now = fallTimers.Now();
+    float y = falling.posY[i], vy = falling.velY[i];
+    uint64_t floorDue = now + TicksToHeight(y, vy, floorTop + EPS + boxDrop, FALL_GRAVITY, dt);
+    uint64_t playerDue = now + TicksToHeight(y, vy, reachTop + sphereDrop, FALL_GRAVITY, dt);
+    FallingHandle h = falling.HandleAt(i);
+    if (floorDue <= now)
+        falling.phase[i] = FALL_NEAR_FLOOR;
+    else if (playerDue <= now)
+    {
+        falling.phase[i] = FALL_NEAR_PLAYER;
+        fallTimers.Schedule(h.slot, floorDue, h.generation);
+    }
+    else
+    {
+        falling.phase[i] = FALL_CLEAR;
+        fallTimers.Schedule(h.slot, std::min(playerDue, floorDue), h.generation);
+    }
+}
 
-    // Clamp X, Z positions to stay within floor bounds
-    player.pos.x = glm::clamp(player.pos.x, -floorHalf + playerHalf, floorHalf - playerHalf);
-    player.pos.z = glm::clamp(player.pos.z, -floorHalf + playerHalf, floorHalf - playerHalf);
+// Fire this tick's landing timers, raising the phase of the objects they belong to.
+// Timers of objects removed since are recognised by their stale generation and dropped.
+void Game::AdvanceFallTimers(float dt, float reachTop)
+{
+    timersFiredLastTick = 0;
+    if (!landingTimers)
+    {
+        timerDt = 0.0f; // re-enabling starts over
+        return;
+    }
+    if (dt != timerDt)
+    {
+        // pending timers counted ticks of another length: re-arm every object for the new one
+        fallTimers.Clear(fallTimers.Now());
+        timerDt = dt;
+        for (size_t i = 0; i < falling.size(); ++i)
+            ArmFalling(i, dt, reachTop);
+    }
+    firedTimers.clear();
+    fallTimers.Advance(firedTimers);
+    for (const TimerEvent &e : firedTimers)
+    {
+        size_t i = falling.Find({e.id, e.tag});
+        if (i == SIZE_MAX)
+            continue;
+        ++timersFiredLastTick;
+        ArmFalling(i, dt, reachTop);
+    }
+}
+// Player collider for one tick; the box is at the end-of-tick pose and move is how
+// far it travelled during the tick (used by the swept test)
+struct PlayerSweep
+{
+    OBB obb;
+    BoundingSphere sphere;
+    HullPose hull;
+    glm::vec3 move;
+};
 
-    // Force Y to stay fixed (horizontal movement only)
-    player.pos.y = player.groundY;
+// Second opinion on an OBB hit from the convex hulls of both models (GJK). Models without
+// a hull (or hullNarrowphase off) keep the OBB answer. playerShift moves the player hull
+// back along its path for the swept test's samples.
+static bool HullsOverlap(const Game &g, const PlayerSweep &player, const ModelCollision &col,
+                         const glm::vec3 &pos, const glm::mat3 &rot, const glm::vec3 &scale,
+                         const glm::vec3 &playerShift, FallingStepResult &out)
+{
+    if (!g.hullNarrowphase || player.hull.hull->empty() || col.hull.empty())
+        return true;
+    ++out.hullTests;
+    HullPose pl = player.hull;
+    pl.pos -= playerShift;
+    HullPose obj;
+    obj.hull = &col.hull;
+    obj.rot = rot;
+    obj.pos = pos;
+    obj.scale = scale;
+    if (GJKOverlap(pl, obj))
+        return true;
+    ++out.hullRejects;
+    return false;
+}
 
-    // ---------- Spawn and falling updates ----------
-    spawnTimer -= dt;
-    if (spawnTimer <= 0.0f)
+// Swept test of falling object i against the player over [0, tEnd] of this tick.
+// The object's bounding sphere is advanced conservatively in the player's frame;
+// the first contact is then confirmed with the box test at interpolated poses,
+// sampled so that neither box can pass through the other between two samples.
+static bool SweptHitTime(const Game &g, size_t i, const ModelCollision &col,
+                         const OBB &objOBB, const BoundingSphere &objSphere,
+                         const PlayerSweep &player, float tEnd, float &outT, FallingStepResult &out)
+{
+    const FallingSet &falling = g.falling;
+    glm::vec3 prev = falling.PrevPos(i);
+    glm::vec3 pos = falling.Pos(i);
+
+    // sphere about the model origin: covers the model in any orientation during the tick
+    float objR = glm::length(objSphere.center - pos) + objSphere.radius;
+
+    // relative motion: keep the player box fixed and move the object by the difference
+    glm::vec3 c0 = prev + player.move;
+    float tSphere;
+    if (!SweptSphereOBB(c0, pos, objR, player.obb, tSphere) || tSphere > tEnd)
+        return false;
+
+    float thinnest = std::min({objOBB.half[0], objOBB.half[1], objOBB.half[2],
+                               player.obb.half[0], player.obb.half[1], player.obb.half[2]});
+    float travel = glm::length(pos - c0) * (tEnd - tSphere);
+    int steps = glm::clamp((int)std::ceil(travel / std::max(thinnest, 1e-3f)), 1, 16);
+    for (int k = 0; k <= steps; ++k)
     {
-        spawnTimer = randf(rng, 0.4f, 0.9f); // slightly varying spawn interval
-        SpawnObject();
+        float t = tSphere + (tEnd - tSphere) * (float)k / (float)steps;
+        glm::vec3 p = glm::mix(prev, pos, t);
+        glm::mat3 r = QuatToMat3(QuatNlerp(falling.PrevOrientation(i), falling.Orientation(i), t));
+        OBB o = WorldOBB(col.box, p, r, falling.modelScale[i]);
+        OBB pl = player.obb;
+        glm::vec3 shift = player.move * (1.0f - t);
+        pl.center -= shift;
+        if (OBBOverlap(pl, o) && HullsOverlap(g, player, col, p, r, falling.modelScale[i], shift, out))
+        {
+            outT = t;
+            return true;
+        }
     }
+    return false;
+}
 
-    // 更新玩家 modelMatrix（把猫脚底对齐地面）
+// Apply the outcome of this tick to object i: removed on a player hit, otherwise
+// snapped onto the floor and listed as landed when it reached it (Update turns landed
+// objects into props, or just removes them)
+static void ResolveFalling(Game &g, size_t i, bool hitPlayer, bool landed, float halfY, FallingStepResult &out)
+{
+    FallingSet &falling = g.falling;
+    if (hitPlayer)
     {
-        float scaleY = playerModel.modelScale.y; // uniform or per-axis
-        float modelWorldY = floorTop - playerModel.bboxMin.y * scaleY;
-        glm::vec3 modelPosWorld(player.pos.x, modelWorldY, player.pos.z);
-        float rotRad = glm::radians(180.0f);
-        player.modelMatrix = MakeModelMatrix(modelPosWorld, glm::vec3(0, 1, 0), rotRad, playerModel.modelScale);
+        out.firstHit = std::min(out.firstHit, i);
+        falling.alive[i] = 0;
+        return;
     }
+    if (!landed)
+        return;
 
-    // 计算玩家的 AABB（world-space half extents），用于碰撞检测
-    glm::vec3 playerHalfExtents = (playerModel.bboxMax - playerModel.bboxMin) * 0.5f * playerModel.modelScale;
-    glm::vec3 playerMin = player.pos - playerHalfExtents;
-    glm::vec3 playerMax = player.pos + playerHalfExtents;
+    // snap object so its bottom sits exactly on floorTop
+    glm::vec3 pos = falling.Pos(i);
+    pos.y = g.floorTop + halfY;
+    falling.SetPos(i, pos);
 
-    auto computeBoundingSphereRadius = [](const glm::vec3 &half) -> float
+    // update modelMatrix to reflect snapped position (only the translation changes)
+    falling.modelMatrix[i][3] = glm::vec4(pos, 1.0f);
+
+    falling.SetVel(i, glm::vec3(0.0f));
+
+    falling.alive[i] = 0;
+    out.landed.push_back((uint32_t)i);
+}
+
+// Step falling objects [begin, end) for one tick and record hits/landings in out.
+// Unlike the old loop this never stops early at a hit, so every chunk layout
+// (including the single serial chunk) leaves the set in the same state.
+static void StepFallingRange(Game &g, size_t begin, size_t end, float dt,
+                             const PlayerSweep &player, FallingStepResult &out)
+{
+    FallingSet &falling = g.falling;
+    out.firstHit = SIZE_MAX;
+    out.landed.clear();
+    out.narrowTests = 0;
+    out.axisCacheHits = 0;
+    out.hullTests = 0;
+    out.hullRejects = 0;
+    out.collisionObjects = 0;
+    const float EPS = 1e-4f;
+
+    // objects that passed the sphere test wait here for one batched OBB test
+    struct Pending
+    {
+        size_t index;
+        float halfY;
+        float bottomY;
+    };
+    OBBBatch batch;
+    Pending pending[OBBBatch::SIZE];
+    bool deferred = false;
+    int8_t axes[OBBBatch::SIZE];
+    auto flushBatch = [&]()
     {
-        // approximate radius = length of half-extents vector
-        return glm::length(half);
+        uint32_t hits = OBBOverlapBatch(player.obb, batch, axes);
+        for (int lane = 0; lane < batch.count; ++lane)
+        {
+            const Pending &p = pending[lane];
+            bool hitPlayer = (hits >> lane) & 1u;
+            if (hitPlayer)
+            {
+                size_t i = p.index;
+                const ModelCollision &col = g.fallingModels[falling.modelIndex[i]].collision;
+                hitPlayer = HullsOverlap(g, player, col, falling.Pos(i), QuatToMat3(falling.Orientation(i)),
+                                         falling.modelScale[i], glm::vec3(0.0f), out);
+            }
+            falling.sepAxis[p.index] = axes[lane];
+            ResolveFalling(g, p.index, hitPlayer, !hitPlayer && p.bottomY <= g.floorTop + EPS, p.halfY, out);
+        }
+        batch.Clear();
     };
 
-    // build player OBB once per frame (use player.modelMatrix and playerModel.bboxMin/Max)
-    OBB playerOBB = BuildOBBFromModel(playerModel.bboxMin, playerModel.bboxMax, player.modelMatrix);
-    float playerSphereR = computeBoundingSphereRadius(glm::vec3(playerOBB.half[0], playerOBB.half[1], playerOBB.half[2]));
+    // 1) physics integrate (SoA, SIMD kernels)
+    IntegrateFalling(falling, begin, end, dt, FALL_GRAVITY);
 
-    for (size_t i = 0; i < falling.size(); ++i)
+    for (size_t i = begin; i < end; ++i)
     {
-        auto &o = falling[i];
-        // build modelMatrix if you expect it prebuilt:
-        glm::mat4 mm = o.modelMatrix;
-        glm::vec4 center = mm * glm::vec4((fallingModels[o.modelIndex].bboxMin + fallingModels[o.modelIndex].bboxMax) * 0.5f, 1.0f);
-    }
+        if (!falling.alive[i])
+            continue;
 
-    for (auto &o : falling)
-    {
-        if (!o.alive)
+        // 2) immediately update modelMatrix from current pos/orientation/scale
+        glm::vec3 pos = falling.Pos(i);
+        glm::mat3 rot = QuatToMat3(falling.Orientation(i));
+        falling.modelMatrix[i] = ComposeTRS(pos, rot, falling.modelScale[i]);
+
+        // objects the landing timers still have out of the player's reach need nothing else
+        uint8_t phase = g.landingTimers ? falling.phase[i] : (uint8_t)FALL_NEAR_FLOOR;
+        if (phase == FALL_CLEAR)
+            continue;
+        ++out.collisionObjects;
+
+        // 3) world sphere from the model's precomputed bounds; the OBB (same rotation) is
+        //    only built for objects near the player or the floor
+        const ModelCollision &col = g.fallingModels[falling.modelIndex[i]].collision;
+        BoundingSphere objSphere = WorldSphere(col.sphere, pos, rot, falling.modelScale[i]);
+        glm::vec3 d = objSphere.center - player.sphere.center;
+        float reach = player.sphere.radius + objSphere.radius;
+        bool nearPlayer = glm::dot(d, d) <= reach * reach;
+        if (!nearPlayer && phase != FALL_NEAR_FLOOR && !g.continuousCollision)
             continue;
+        OBB objOBB = WorldOBB(col.box, pos, rot, falling.modelScale[i]);
 
-        // 1) physics integrate
-        o.vel += glm::vec3(0.0f, -9.8f * dt * 0.2f, 0.0f);
-        o.pos += o.vel * dt;
-        if (fabs(o.rotSpeed) > 1e-6f)
-            o.rot += o.rotSpeed * dt;
+        // ground contact uses the OBB bottom (more robust than o.pos +/- halfExtents)
+        float objBottomY = objOBB.center.y - objOBB.half[1];
 
-        // 2) immediately update modelMatrix from current pos/rot/scale
+        if (g.continuousCollision)
         {
-            glm::mat4 mm(1.0f);
-            mm = glm::translate(mm, o.pos);
-            mm = glm::rotate(mm, o.rot, o.rotAxis);
-            mm = glm::scale(mm, o.modelScale);
-            o.modelMatrix = mm;
+            // 4) analytic floor time of impact (bottom moves linearly within the tick),
+            //    then the swept player test up to that time: whichever comes first wins
+            float prevBottomY = objBottomY - (pos.y - falling.prevY[i]);
+            float tFloor = 1.0f, tHit;
+            bool landed = FloorTimeOfImpact(prevBottomY, objBottomY, g.floorTop + EPS, tFloor);
+            bool hitPlayer = SweptHitTime(g, i, col, objOBB, objSphere, player, tFloor, tHit, out);
+            ResolveFalling(g, i, hitPlayer, landed && !hitPlayer, objOBB.half[1], out);
+            continue;
         }
 
-        // 3) build object OBB from proto bbox and the up-to-date modelMatrix
-        const glm::vec3 &pbMin = fallingModels[o.modelIndex].bboxMin;
-        const glm::vec3 &pbMax = fallingModels[o.modelIndex].bboxMax;
-        OBB objOBB = BuildOBBFromModel(pbMin, pbMax, o.modelMatrix);
-
-        // (optional) update instance halfExtents from OBB for consistent later use
-        o.halfExtents = glm::vec3(objOBB.half[0], objOBB.half[1], objOBB.half[2]);
-
-        // 4) broadphase sphere test vs player (playerOBB must be computed once per frame outside loop)
-        float objSphereR = glm::length(glm::vec3(objOBB.half[0], objOBB.half[1], objOBB.half[2]));
-        float centersDist = glm::length(objOBB.center - playerOBB.center);
-        if (centersDist <= (playerSphereR + objSphereR))
+        // 4) broadphase sphere test vs player (squared distances, tight spheres)
+        if (nearPlayer)
         {
-            // narrowphase SAT test (OBB vs OBB)
-            if (OBBIntersectSAT(playerOBB, objOBB))
+            // motion between ticks is small, so the axis that separated last time usually
+            // still does; only when it fails is the object queued for the full test
+            ++out.narrowTests;
+            int8_t cached = falling.sepAxis[i];
+            if (g.separatingAxisCache && cached >= 0 && OBBSeparatedOnAxis(player.obb, objOBB, cached))
             {
-                playerDead = true;
-                std::cout << "[Collide] player hit by falling object\n";
-                o.alive = false;
-                break;
+                ++out.axisCacheHits;
+                ResolveFalling(g, i, false, objBottomY <= g.floorTop + EPS, objOBB.half[1], out);
+                continue;
             }
-        }
 
-        // 5) ground contact test using OBB bottom (more robust than o.pos +/- halfExtents)
-        float objBottomY = objOBB.center.y - objOBB.half[1];
-        const float EPS = 1e-4f;
-        if (objBottomY <= floorTop + EPS)
-        {
-            // snap object so its bottom sits exactly on floorTop
-            o.pos.y = floorTop + objOBB.half[1];
+            // narrowphase OBB test runs batched (SSE/AVX) once 8 candidates are queued
+            pending[batch.Add(objOBB)] = {i, objOBB.half[1], objBottomY};
+            deferred = true;
+            if (batch.Full())
+                flushBatch();
+            continue;
+        }
 
-            // update modelMatrix to reflect snapped position
-            glm::mat4 mm(1.0f);
-            mm = glm::translate(mm, o.pos);
-            mm = glm::rotate(mm, o.rot, o.rotAxis);
-            mm = glm::scale(mm, o.modelScale);
-            o.modelMatrix = mm;
+        // 5) ground contact
+        ResolveFalling(g, i, false, objBottomY <= g.floorTop + EPS, objOBB.half[1], out);
+    }
+    flushBatch();
 
-            o.vel = glm::vec3(0.0f);
-            // optionally zero angular motion
-            // o.rotSpeed = 0.0f; o.angVel = glm::vec3(0.0f);
+    // batched candidates resolve late; keep landings in index order for every chunk layout
+    if (deferred)
+        std::sort(out.landed.begin(), out.landed.end());
+}
 
-            o.alive = false; // or set state = LANDED if you want to keep it visible
+// Falling objects that came down onto a pile land there instead of on the floor, keeping
+// their velocity so the prop solver can settle them. Runs serially after the chunked step
+// (prop queries share scratch buffers); objects above every prop are rejected up front.
+void Game::LandOnProps()
+{
+    if (props.size() == 0)
+        return;
+    const float topY = props.TopY();
+    for (size_t i = 0; i < falling.size(); ++i)
+    {
+        if (!falling.alive[i])
+            continue;
+        const ModelCollision &col = fallingModels[falling.modelIndex[i]].collision;
+        const glm::vec3 &scale = falling.modelScale[i];
+        // bounding sphere about the origin covers every orientation
+        float reach = glm::length(col.sphere.center * scale) + col.sphere.radius * std::max({scale.x, scale.y, scale.z});
+        if (falling.posY[i] - reach > topY)
             continue;
-        }
 
-        // If we reach here, the object continues falling that frame
+        // same contact sphere PropSet::Add will give it
+        OBB obb = WorldOBB(col.box, falling.Pos(i), QuatToMat3(falling.Orientation(i)), scale);
+        float r = (obb.half[0] + obb.half[1] + obb.half[2]) / 3.0f;
+        if (props.TouchesSphere(obb.center, r))
+        {
+            falling.alive[i] = 0;
+            landedThisTick.push_back((uint32_t)i);
+        }
     }
-    // remove dead (landed or collided) instances
-    falling.erase(std::remove_if(falling.begin(), falling.end(),
-                                 [](const Falling &f)
-                                 { return !f.alive; }),
-                  falling.end());
 }
 
-void Game::Render(unsigned int shader3D, const glm::vec3 &cameraPos)
+void Game::Advance(float frameDt, const bool keys[1024], const glm::vec3 &cameraFront, const glm::vec3 &cameraUp)
 {
-    /* =========================================================
-       1. 计算太阳光矩阵（Directional Light）
-       ========================================================= */
-    glm::vec3 sunDir = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.2f));
-
-    float lightDist = 20.0f;
-    glm::mat4 lightView = glm::lookAt(
-        -sunDir * lightDist,
-        glm::vec3(0.0f),
-        glm::vec3(0, 1, 0));
-
-    float orthoSize = 15.0f;
-    glm::mat4 lightProj = glm::ortho(
-        -orthoSize, orthoSize,
-        -orthoSize, orthoSize,
-        1.0f, 50.0f);
-
-    glm::mat4 lightVP = lightProj * lightView;
-
-    GLint prevViewport[4];
-    glGetIntegerv(GL_VIEWPORT, prevViewport);
-
-    /* =========================================================
-       2. Shadow Pass（只画深度，只画真实模型）
-       ========================================================= */
-    if (depthFBO && shadowShader)
+    const float step = 1.0f / simHz;
+    accumulator += frameDt;
+    int substeps = 0;
+    while (accumulator >= step && substeps < maxSubsteps && !playerDead)
     {
-        glViewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
-        glBindFramebuffer(GL_FRAMEBUFFER, depthFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
+        Update(step, keys, cameraFront, cameraUp);
+        accumulator -= step;
+        ++substeps;
+    }
+    // after a long hitch, drop the backlog instead of spiralling into ever more ticks
+    if (accumulator >= step)
+        accumulator = std::fmod(accumulator, step);
+    renderAlpha = glm::clamp(accumulator / step, 0.0f, 1.0f);
+}
 
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonOffset(2.0f, 4.0f);
+glm::mat4 Game::PlayerModelMatrix(const glm::vec3 &pos) const
+{
+    float scaleY = playerModel.modelScale.y; // uniform or per-axis
+    float modelWorldY = floorTop - playerModel.bboxMin.y * scaleY;
+    glm::vec3 modelPosWorld(pos.x, modelWorldY, pos.z);
+    return ComposeTRS(modelPosWorld, PlayerRotation(), playerModel.modelScale);
+}
 
-        glUseProgram(shadowShader);
-        glUniformMatrix4fv(
-            glGetUniformLocation(shadowShader, "uLightVP"),
-            1, GL_FALSE, &lightVP[0][0]);
+glm::vec3 Game::RenderPlayerPos() const
+{
+    return glm::mix(player.prevPos, player.pos, renderAlpha);
+}
 
-        auto setShadowModel = [&](const glm::mat4 &m)
-        {
-            glUniformMatrix4fv(
-                glGetUniformLocation(shadowShader, "uModel"),
-                1, GL_FALSE, &m[0][0]);
-        };
+void Game::Update(float dt, const bool keys[1024], const glm::vec3 &cameraFront, const glm::vec3 &cameraUp)
+{
+    if (playerDead)
+        return;
+    uint64_t allocStart = HeapAllocationCount();
 
-        /* ---- floor ---- */
-        {
-            glm::mat4 m = floorModel.modelMatrix; // 已在初始化阶段算好
-            setShadowModel(m);
-            floorModel.DrawDepth();
-        }
+    const float floorTop = -0.5f;
+    // remember where this tick started so Render can interpolate
+    player.prevPos = player.pos;
+    falling.SaveState();
 
-        /* ---- player ---- */
-        {
-            glm::mat4 m = player.modelMatrix;
-            setShadowModel(m);
-            playerModel.DrawDepth();
-        }
+    player.Update(dt, keys, cameraFront, cameraUp);
 
-        /* ---- falling objects ---- */
-        for (auto &o : falling)
-        {
-            glm::mat4 m = o.modelMatrix;
-            setShadowModel(m);
-            fallingModels[o.modelIndex].DrawDepth();
-        }
+    const float floorHalf = 12.0f * 0.5f; // = 6.0f
 
-        glDisable(GL_POLYGON_OFFSET_FILL);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(prevViewport[0], prevViewport[1],
-                   prevViewport[2], prevViewport[3]);
-    }
+    // Player radius (0.6 scaled cube)
+    const float playerHalf = 0.3f;
 
-    /* =========================================================
-       3. Main Pass（正常渲染）
-       ========================================================= */
-    glUseProgram(shader3D);
+    // Clamp X, Z positions to stay within floor bounds
+    player.pos.x = glm::clamp(player.pos.x, -floorHalf + playerHalf, floorHalf - playerHalf);
+    player.pos.z = glm::clamp(player.pos.z, -floorHalf + playerHalf, floorHalf - playerHalf);
 
-    /* ---- camera & light ---- */
-    glUniform3fv(
-        glGetUniformLocation(shader3D, "uViewPos"),
-        1, &cameraPos[0]);
+    // Force Y to stay fixed (horizontal movement only)
+    player.pos.y = player.groundY;
 
-    glUniform3fv(
-        glGetUniformLocation(shader3D, "uLightDir"),
-        1, &sunDir[0]);
+    // landed props block the player (a cylinder standing on the floor)
+    if (props.size() > 0)
+    {
+        float height = (playerModel.bboxMax.y - playerModel.bboxMin.y) * playerModel.modelScale.y;
+        glm::vec3 base = props.PushOutCylinder(glm::vec3(player.pos.x, floorTop, player.pos.z), playerHalf, height);
+        player.pos.x = glm::clamp(base.x, -floorHalf + playerHalf, floorHalf - playerHalf);
+        player.pos.z = glm::clamp(base.z, -floorHalf + playerHalf, floorHalf - playerHalf);
+    }
 
-    glUniform3f(
-        glGetUniformLocation(shader3D, "uLightColor"),
-        1.0f, 0.98f, 0.9f);
+    // 更新玩家 modelMatrix（把猫脚底对齐地面）
+    player.modelMatrix = PlayerModelMatrix(player.pos);
 
-    glUniform1f(
-        glGetUniformLocation(shader3D, "uLightIntensity"),
-        1.2f);
+    // 计算玩家的 AABB（world-space half extents），用于碰撞检测
+    glm::vec3 playerHalfExtents = (playerModel.bboxMax - playerModel.bboxMin) * 0.5f * playerModel.modelScale;
+    glm::vec3 playerMin = player.pos - playerHalfExtents;
+    glm::vec3 playerMax = player.pos + playerHalfExtents;
 
-    /* ---- shadow uniforms ---- */
-    glUniformMatrix4fv(
-        glGetUniformLocation(shader3D, "uLightVP"),
-        1, GL_FALSE, &lightVP[0][0]);
+    // build player OBB and sphere once per tick from the precomputed model bounds
+    PlayerSweep playerSweep;
+    glm::vec3 playerModelPos(player.modelMatrix[3]);
+    playerSweep.obb = WorldOBB(playerModel.collision.box, playerModelPos, PlayerRotation(), playerModel.modelScale);
+    playerSweep.sphere = WorldSphere(playerModel.collision.sphere, playerModelPos, PlayerRotation(), playerModel.modelScale);
+    playerSweep.hull.hull = &playerModel.collision.hull;
+    playerSweep.hull.rot = PlayerRotation();
+    playerSweep.hull.pos = playerModelPos;
+    playerSweep.hull.scale = playerModel.modelScale;
+    playerSweep.move = player.pos - player.prevPos;
 
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glUniform1i(
-        glGetUniformLocation(shader3D, "uShadowMap"),
-        3);
+    // ---------- Spawn and falling updates ----------
+    // highest point the player's sphere or box reaches (the player never leaves the floor)
+    float reachTop = std::max(playerSweep.sphere.center.y + playerSweep.sphere.radius, OBBBounds(playerSweep.obb).max.y);
+    AdvanceFallTimers(dt, reachTop);
+    spawnTimer -= dt;
+    if (spawnTimer <= 0.0f)
+    {
+        spawnTimer = randf(rng, 0.4f, 0.9f); // slightly varying spawn interval
+        FallingHandle h = SpawnObject();
+        if (landingTimers && h.valid())
+            ArmFalling(falling.Find(h), dt, reachTop);
+    }
 
-    auto setModelAndNormal = [&](const glm::mat4 &m)
+    // per-object step: integrate -> OBB -> broadphase -> SAT -> floor contact.
+    // Each object only touches its own slots, so chunks can run on any thread.
+    const size_t count = falling.size();
+    size_t chunkSize = std::max<size_t>((parallelChunkSize + 7) & ~size_t(7), 8);
+    size_t chunkCount = parallelUpdate ? (count + chunkSize - 1) / chunkSize : 1;
+    if (!parallelUpdate)
+        chunkSize = count;
+    if (stepResults.size() < chunkCount)
+        stepResults.resize(chunkCount);
+
+    auto stepChunk = [&](size_t chunk)
     {
-        glUniformMatrix4fv(
-            glGetUniformLocation(shader3D, "uModel"),
-            1, GL_FALSE, &m[0][0]);
-
-        glm::mat3 normalMat = glm::transpose(glm::inverse(glm::mat3(m)));
-        glUniformMatrix3fv(
-            glGetUniformLocation(shader3D, "uNormalMat"),
-            1, GL_FALSE, &normalMat[0][0]);
+        size_t begin = chunk * chunkSize;
+        size_t end = std::min(begin + chunkSize, count);
+        StepFallingRange(*this, begin, end, dt, playerSweep, stepResults[chunk]);
     };
-    glEnableVertexAttribArray(1); // normal attribute
-    /* ---- floor ---- */
+    if (parallelUpdate)
+        workerPool.Run(chunkCount, stepChunk);
+    else if (count > 0)
+        stepChunk(0);
+
+    // merge in chunk order so the outcome does not depend on scheduling
+    landedThisTick.clear();
+    narrowTestsLastTick = 0;
+    axisCacheHitsLastTick = 0;
+    hullTestsLastTick = 0;
+    hullRejectsLastTick = 0;
+    fallingSteppedLastTick = (uint32_t)count;
+    collisionObjectsLastTick = 0;
+    size_t firstHit = SIZE_MAX;
+    for (size_t c = 0; c < chunkCount && count > 0; ++c)
     {
-        setModelAndNormal(floorModel.modelMatrix);
-
-        glUniform1i(glGetUniformLocation(shader3D, "uHasDiffuse"), 1);
-        glUniform1i(glGetUniformLocation(shader3D, "uUseAlphaTest"), 0);
-        glUniform1i(glGetUniformLocation(shader3D, "uDiffuseMap"), 0);
-
-        glActiveTexture(GL_TEXTURE0);
-        floorModel.Draw(shader3D);
+        const FallingStepResult &r = stepResults[c];
+        if (firstHit == SIZE_MAX)
+            firstHit = r.firstHit;
+        landedThisTick.insert(landedThisTick.end(), r.landed.begin(), r.landed.end());
+        narrowTestsLastTick += r.narrowTests;
+        axisCacheHitsLastTick += r.axisCacheHits;
+        hullTestsLastTick += r.hullTests;
+        hullRejectsLastTick += r.hullRejects;
+        collisionObjectsLastTick += r.collisionObjects;
     }
-
-    /* ---- player ---- */
+    if (firstHit != SIZE_MAX)
     {
-        setModelAndNormal(player.modelMatrix);
-
-        glUniform1i(glGetUniformLocation(shader3D, "uHasDiffuse"), 1);
-        glUniform1i(glGetUniformLocation(shader3D, "uUseAlphaTest"), 1);
-        glUniform1f(glGetUniformLocation(shader3D, "uAlphaCutoff"), 0.3f);
-        glUniform1i(glGetUniformLocation(shader3D, "uDiffuseMap"), 0);
-
-        glActiveTexture(GL_TEXTURE0);
-        playerModel.Draw(shader3D);
+        playerDead = true;
+        std::cout << "[Collide] player hit by falling object\n";
     }
 
-    /* ---- falling objects ---- */
-    for (auto &o : falling)
+    // landed objects become props; new ones start moving next tick, since this tick's
+    // motion was already integrated by the falling step
+    if (keepLanded)
     {
-        setModelAndNormal(o.modelMatrix);
-
-        glUniform1i(glGetUniformLocation(shader3D, "uHasDiffuse"), 1);
-        glUniform1i(glGetUniformLocation(shader3D, "uUseAlphaTest"), 0);
-        glUniform1i(glGetUniformLocation(shader3D, "uDiffuseMap"), 0);
-
-        glActiveTexture(GL_TEXTURE0);
-        fallingModels[o.modelIndex].Draw(shader3D);
+        props.Step(dt, FALL_GRAVITY, floorTop);
+        LandOnProps();
+        for (uint32_t i : landedThisTick)
+        {
+            int m = falling.modelIndex[i];
+            props.Add(falling.Pos(i), falling.Orientation(i), falling.Vel(i), falling.modelScale[i],
+                      falling.color[i], m, fallingModels[m].collision.box);
+        }
     }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // remove dead (landed or collided) instances
+    falling.RemoveDead();
+
+    allocationsLastTick = HeapAllocationCount() - allocStart;
 }
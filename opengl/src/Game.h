@@ -1,63 +1,100 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 #include <vector>
+#include <cstdint>
 #include <random>
 #include <iostream>
 #include <glm/glm.hpp>
 #include "Player.h"
-#include "StaticModel.h"
-#include "Shader.h"
+#include "ModelData.h"
+#include "FallingSet.h"
+#include "Props.h"
+#include "TimingWheel.h"
+#include "ThreadPool.h"
 
-struct Falling
+// Outcome of stepping one chunk of falling objects; chunks are merged in index order
+struct FallingStepResult
 {
-    glm::vec3 pos;
-    glm::vec3 vel;
-    glm::vec3 color;
-    bool alive;
-    float rot;            // current rotation angle (radians)
-    glm::vec3 rotAxis;    // rotation axis
-    float rotSpeed;       // radians per second
-    glm::vec3 modelScale; // instance scale
-    glm::mat4 modelMatrix;
-    glm::vec3 halfExtents; // for AABB collision
-    int modelIndex;        // which model to use (if multiple)
+    size_t firstHit = SIZE_MAX;   // lowest index in the chunk that hit the player
+    std::vector<uint32_t> landed; // indices that reached the floor this tick
+    uint32_t narrowTests = 0;     // player OBB tests run (objects that passed the sphere test)
+    uint32_t axisCacheHits = 0;   // ... of which the cached separating axis settled
+    uint32_t hullTests = 0;       // GJK hull tests run (OBB hits on models with hulls)
+    uint32_t hullRejects = 0;     // ... that found the hulls apart (OBB false positives)
+    uint32_t collisionObjects = 0; // objects the landing timers had near the player or floor
 };
 
 class Game
 {
 public:
     Player player;
-    std::vector<Falling> falling;
-    StaticModel fallingPrototype; // e.g. crate model
-    StaticModel floorModel;       // detailed floor model
-    StaticModel fallingModels[3]; // optional multiple falling models
+    FallingSet falling;
+    PropSet props; // landed objects kept in the scene (when keepLanded is on)
+    // CPU-side model data only; GameRenderer owns the matching GL resources
+    ModelData floorModel;       // detailed floor model
+    ModelData fallingModels[3]; // optional multiple falling models
     float floorTop = -0.5f;       // 可在 LoadResources 后用 floorModel bbox 覆盖
     float floorYOffset;
     float spawnTimer;
     bool playerDead;
 
     std::mt19937 rng;
-    // ===== Shadow mapping =====
-    unsigned int depthFBO = 0;
-    unsigned int depthMap = 0;
+    uint32_t seed = 0;      // RNG seed of the current run (re-applied by Reset)
+    bool fixedSeed = false; // false: Reset picks a fresh clock-based seed each run
 
-    static constexpr unsigned int SHADOW_SIZE = 2048;
+    // falling-object pool capacity; spawns are skipped while the pool is full
+    static constexpr size_t MAX_FALLING = 16384;
+    // landed-prop capacity; once full, further landings are removed as before
+    static constexpr size_t MAX_PROPS = 4096;
 
-    // shadow shader program id
-    unsigned int shadowShader = 0;
+    // ===== Fixed timestep =====
+    float simHz = 60.0f;      // simulation tick rate, independent of the render frame rate
+    int maxSubsteps = 8;      // max ticks per rendered frame; time beyond that is dropped
+    float renderAlpha = 1.0f; // blend between previous and current tick used by Render
+
+    // ===== Falling-object update =====
+    bool parallelUpdate = true;      // false runs the same per-object step serially (for comparison)
+    size_t parallelChunkSize = 1024; // objects per chunk (kept a multiple of 8 for the SIMD kernels)
+    // swept tests between the previous and current tick instead of testing end positions only;
+    // catches fast objects (or low simHz) that would otherwise step through the player
+    bool continuousCollision = false;
+    // landed objects stay as props that pile up and block the player; false removes them on landing
+    bool keepLanded = true;
+    // try each object's separating axis from its previous test before the full 15-axis test
+    bool separatingAxisCache = true;
+    uint32_t narrowTestsLastTick = 0;   // player OBB tests in the last tick
+    uint32_t axisCacheHitsLastTick = 0; // ... settled by the cached axis alone
+    // confirm OBB hits with GJK on the models' convex hulls, so box corners sticking out
+    // past the actual shape no longer count as hits (the reduced hulls contain the exact
+    // ones, so this only ever drops hits, never real contacts)
+    bool hullNarrowphase = true;
+    uint32_t hullTestsLastTick = 0;   // GJK hull tests in the last tick
+    uint32_t hullRejectsLastTick = 0; // ... that overruled an OBB hit
+    // predict from each object's ballistic path when it can first come within the player's
+    // reach and down to the floor, and skip its collision work until then (timing wheel)
+    bool landingTimers = true;
+    uint32_t fallingSteppedLastTick = 0;   // falling objects stepped in the last tick
+    uint32_t collisionObjectsLastTick = 0; // ... of which needed collision work
+    uint32_t timersFiredLastTick = 0;      // landing timers that came due in the last tick
+    std::vector<uint32_t> landedThisTick; // objects that reached the floor or a pile in the last tick
+    uint64_t allocationsLastTick = 0;     // heap allocations made by the last Update (0 in steady state)
 
     Game();
-    void InitShadowMap();
     void Reset();
+    // Feed wall-clock frame time; runs as many fixed ticks of Update as have accumulated
+    void Advance(float frameDt, const bool keys[1024], const glm::vec3 &cameraFront, const glm::vec3 &cameraUp);
+    // One fixed simulation tick
     void Update(float dt, const bool keys[1024], const glm::vec3 &cameraFront, const glm::vec3 &cameraUp);
-    void Render(unsigned int shader3D, const glm::vec3 &cameraPos);
-    void SetCubeVAO(unsigned int vao) { cubeVAO = vao; }
+    // Player position interpolated for the current frame (use for camera follow)
+    glm::vec3 RenderPlayerPos() const;
+    // World transform of the player model standing at pos (feet on the floor)
+    glm::mat4 PlayerModelMatrix(const glm::vec3 &pos) const;
 
-    StaticModel playerModel;
+    ModelData playerModel;
 
-    void LoadPlayerModel(const std::string &path)
+    void LoadPlayerModel(const std::string &path, bool keepGeometry = true)
     {
-        if (!playerModel.LoadFromFile(path))
+        if (!playerModel.LoadFromFile(path, keepGeometry))
         {
             std::cerr << "Failed to load player model: " << path << std::endl;
         }
@@ -69,10 +106,19 @@ public:
         }
     }
 
-    bool LoadResources(const std::string &assetsDir);
+    // keepGeometry = false keeps only bounds (enough for the simulation, nothing to upload)
+    bool LoadResources(const std::string &assetsDir, bool keepGeometry = true);
 
 private:
-    unsigned int cubeVAO = 0;
-    void SpawnObject();
+    float accumulator = 0.0f;
+    ThreadPool workerPool;
+    std::vector<FallingStepResult> stepResults; // one per chunk, reused across ticks
+    TimingWheel fallTimers;                     // ids are FallingSet slots, tags their generation
+    std::vector<TimerEvent> firedTimers;        // scratch for fallTimers.Advance
+    float timerDt = 0.0f;                       // tick length the pending timers were computed with
+    FallingHandle SpawnObject();
+    void AdvanceFallTimers(float dt, float reachTop);
+    void ArmFalling(size_t i, float dt, float reachTop);
+    void LandOnProps();
 };
 #endif
@@ -0,0 +1,502 @@
+#include "GameRenderer.h"
+#include "Game.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+bool GameRenderer::Init(const Game &game)
+{
+    bool ok = true;
+    for (int i = 0; i < 3; ++i)
+    {
+        fallingModels[i].vertexFormat = vertexFormat;
+        ok &= fallingModels[i].Upload(game.fallingModels[i]);
+    }
+    floorModel.vertexFormat = vertexFormat;
+    ok &= floorModel.Upload(game.floorModel);
+    playerModel.vertexFormat = vertexFormat;
+    ok &= playerModel.Upload(game.playerModel);
+    if (!ok)
+        std::cerr << "GameRenderer: failed to upload models\n";
+    std::cout << "GameRenderer: uploaded " << GeometryBytes() / 1024 << " KB of vertex/index data\n";
+    InitUniformBuffers();
+    return ok;
+}
+
+size_t GameRenderer::GeometryBytes() const
+{
+    size_t bytes = floorModel.GeometryBytes() + playerModel.GeometryBytes();
+    for (const StaticModel &model : fallingModels)
+        bytes += model.GeometryBytes();
+    return bytes;
+}
+
+void GameRenderer::InitUniformBuffers()
+{
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), nullptr, GL_STREAM_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, frameUBO);
+
+    glGenBuffers(1, &lightUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, lightUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), nullptr, GL_STREAM_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, lightUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void GameRenderer::UploadFrameBlocks(const FrameBlock &frame, const LightBlock &light)
+{
+    // orphan last frame's storage so the driver doesn't wait on draws still reading it;
+    // the buffers stay bound to their binding points, so no program needs touching
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &frame);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, lightUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightBlock), &light);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+std::string ShadowQualityDefines(ShadowQuality quality)
+{
+    static const int taps[] = {1, 4, 8, 16};
+    return "#define SHADOW_TAPS " + std::to_string(taps[glm::clamp((int)quality, 0, 3)]) + "\n";
+}
+
+bool ShadowQualityFromName(const char *name, ShadowQuality &quality)
+{
+    static const char *names[] = {"low", "medium", "high", "ultra"};
+    for (int q = 0; q < 4; ++q)
+    {
+        if (std::strcmp(name, names[q]) == 0)
+        {
+            quality = (ShadowQuality)q;
+            return true;
+        }
+    }
+    return false;
+}
+
+// depth texture + framebuffer for one shadow map
+static void CreateDepthTarget(unsigned int size, unsigned int &fbo, unsigned int &depthMap)
+{
+    glGenFramebuffers(1, &fbo);
+
+    // depth texture
+    glGenTextures(1, &depthMap);
+    glBindTexture(GL_TEXTURE_2D, depthMap);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
+                 size, size, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+    // sampled as sampler2DShadow: each fetch compares against 4 texels and filters the results
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+    float borderColor[] = {1.0, 1.0, 1.0, 1.0};
+    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+    // attach
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                           GL_TEXTURE_2D, depthMap, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+}
+
+void GameRenderer::InitShadowMap()
+{
+    // ===== One depth texture + framebuffer per cascade =====
+    // separate textures rather than an array texture, so each cascade has its own size;
+    // the static layer matches its cascade's format and size so it can be blitted in
+    cascadeCount = glm::clamp(cascadeCount, 1, MAX_CASCADES);
+    for (int c = 0; c < cascadeCount; ++c)
+    {
+        ShadowCascade &sc = cascades[c];
+        sc.size = cascadeSettings[c].size;
+        CreateDepthTarget(sc.size, sc.fbo, sc.depthMap);
+        if (staticShadowCache)
+            CreateDepthTarget(sc.size, sc.staticFbo, sc.staticMap);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+unsigned int GameRenderer::DueCascades() const
+{
+    unsigned int due = 0;
+    for (int c = 0; c < cascadeCount; ++c)
+    {
+        if (!cascades[c].fbo)
+            continue;
+        // stagger cascades with the same interval so they don't all land on one frame
+        unsigned int interval = (unsigned int)std::max(cascadeSettings[c].updateInterval, 1);
+        if (!cascades[c].rendered || frameIndex % interval == (unsigned int)c % interval)
+            due |= 1u << c;
+    }
+    return due;
+}
+
+void GameRenderer::GatherInstances(const Game &game)
+{
+    const FallingSet &falling = game.falling;
+    const PropSet &props = game.props;
+    size_t n = falling.size() + props.size();
+    worldInstances.resize(n);
+    worldModel.resize(n);
+    sphereX.resize(n);
+    sphereY.resize(n);
+    sphereZ.resize(n);
+    sphereR.resize(n);
+
+    auto add = [&](size_t k, const glm::mat4 &m, const glm::vec3 &color, int model)
+    {
+        worldInstances[k] = {m, color};
+        worldModel[k] = (uint8_t)model;
+        BoundingSphere s = TransformSphere(fallingModels[model].boundingSphere, m);
+        sphereX[k] = s.center.x;
+        sphereY[k] = s.center.y;
+        sphereZ[k] = s.center.z;
+        sphereR[k] = s.radius;
+    };
+    size_t k = 0;
+    for (size_t i = 0; i < falling.size(); ++i, ++k)
+        add(k, falling.InterpolatedMatrix(i, game.renderAlpha), falling.color[i], falling.modelIndex[i]);
+    // landed props share the falling models
+    for (size_t i = 0; i < props.size(); ++i, ++k)
+        add(k, props.InterpolatedMatrix(i, game.renderAlpha), props.color[i], props.modelIndex[i]);
+}
+
+void GameRenderer::CullInstances(const Frustum &view, const Frustum *cascadeFrusta, unsigned int due)
+{
+    size_t n = worldInstances.size();
+    visibleMain.resize(n);
+    for (int c = 0; c < cascadeCount; ++c)
+        visibleShadow[c].resize(n);
+    if (!frustumCulling)
+    {
+        std::fill(visibleMain.begin(), visibleMain.end(), 1);
+        for (int c = 0; c < cascadeCount; ++c)
+            std::fill(visibleShadow[c].begin(), visibleShadow[c].end(), 1);
+        return;
+    }
+    size_t drawn = CullSpheres(view, sphereX.data(), sphereY.data(), sphereZ.data(), sphereR.data(), n, visibleMain.data());
+    mainCull.tested += (uint32_t)n;
+    mainCull.drawn += (uint32_t)drawn;
+    mainCull.culled += (uint32_t)(n - drawn);
+    for (int c = 0; c < cascadeCount; ++c)
+    {
+        if (!(due & (1u << c)))
+            continue;
+        drawn = CullSpheres(cascadeFrusta[c], sphereX.data(), sphereY.data(), sphereZ.data(), sphereR.data(), n,
+                            visibleShadow[c].data());
+        shadowCull.tested += (uint32_t)n;
+        shadowCull.drawn += (uint32_t)drawn;
+        shadowCull.culled += (uint32_t)(n - drawn);
+    }
+}
+
+// Stream instances into a buffer, growing it geometrically so bursts of spawns don't
+// resize every frame, and orphaning the old storage so the driver doesn't stall on last
+// frame's draws
+static void StreamInstances(unsigned int vbo, size_t &capacity, const std::vector<InstanceData> &data)
+{
+    size_t count = data.size();
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (count > capacity)
+        capacity = std::max<size_t>(count * 2, 64);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+    if (count)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData), data.data());
+}
+
+void GameRenderer::UploadFallingInstances(unsigned int due)
+{
+    // clear keeps the capacity, so the vectors stop growing once they have held the most
+    // instances actually seen
+    for (int i = 0; i < 3; ++i)
+    {
+        instanceData[i].clear();
+        shadowInstanceData[i].clear();
+    }
+    for (size_t k = 0; k < worldInstances.size(); ++k)
+    {
+        if (visibleMain[k])
+            instanceData[worldModel[k]].push_back(worldInstances[k]);
+    }
+    // cascade after cascade, so each one's casters are a contiguous range
+    for (int c = 0; c < cascadeCount; ++c)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            shadowFirst[i][c] = shadowInstanceData[i].size();
+            shadowCount[i][c] = 0;
+        }
+        if (!(due & (1u << c)))
+            continue;
+        const std::vector<uint8_t> &visible = visibleShadow[c];
+        for (size_t k = 0; k < worldInstances.size(); ++k)
+        {
+            if (visible[k])
+                shadowInstanceData[worldModel[k]].push_back(worldInstances[k]);
+        }
+        for (int i = 0; i < 3; ++i)
+            shadowCount[i][c] = shadowInstanceData[i].size() - shadowFirst[i][c];
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (!instanceVBO[i])
+        {
+            glGenBuffers(1, &instanceVBO[i]);
+            glGenBuffers(1, &shadowInstanceVBO[i]);
+            fallingModels[i].AttachInstanceBuffers(instanceVBO[i], shadowInstanceVBO[i]);
+        }
+        StreamInstances(instanceVBO[i], instanceCapacity[i], instanceData[i]);
+        StreamInstances(shadowInstanceVBO[i], shadowInstanceCapacity[i], shadowInstanceData[i]);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+void GameRenderer::Render(const Game &game, const Shader &shader3D, const glm::mat4 &view, const glm::mat4 &proj,
+                          const glm::vec3 &cameraPos)
+{
+    static const UniformId uCascade = Shader::Id("uCascade");
+    static const UniformId uShadowMaps[MAX_CASCADES] = {
+        Shader::Id("uShadowMaps[0]"), Shader::Id("uShadowMaps[1]"),
+        Shader::Id("uShadowMaps[2]"), Shader::Id("uShadowMaps[3]")};
+
+    /* =========================================================
+       1. 计算太阳光矩阵（Directional Light）—— one per cascade
+       ========================================================= */
+    glm::vec3 sunDir = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.2f));
+
+    bool shadowPass = shadowShader && cascades[0].fbo;
+    unsigned int due = shadowPass ? DueCascades() : 0;
+
+    float nearZ, farZ;
+    ProjectionDepthRange(proj, nearZ, farZ);
+    farZ = std::min(farZ, shadowDistance);
+    float splitFar[MAX_CASCADES];
+    ComputeCascadeSplits(nearZ, farZ, cascadeCount, cascadeSplitLambda, splitFar);
+
+    // static geometry only changes on a reset, if at all
+    if (game.floorModel.modelMatrix != staticFloorMatrix)
+    {
+        staticFloorMatrix = game.floorModel.modelMatrix;
+        ++staticVersion;
+    }
+    bool cacheStatic = staticShadowCache && cascades[0].staticFbo;
+
+    // refit the cascades rendered this frame; the others keep the matrix their map was made with.
+    // A due cascade whose static layer was made with another matrix rebuilds it.
+    Frustum cascadeFrusta[MAX_CASCADES];
+    unsigned int rebuild = 0;
+    float sliceNear = nearZ;
+    for (int c = 0; c < cascadeCount; ++c)
+    {
+        ShadowCascade &sc = cascades[c];
+        if (due & (1u << c))
+        {
+            glm::vec3 corners[8];
+            FrustumSliceCorners(view, proj, sliceNear, splitFar[c], corners);
+            sc.viewProj = FitCascade(corners, sunDir, sc.size, casterDistance, cacheStatic ? staticCacheSnap : 1);
+            cascadeFrusta[c] = FrustumFromMatrix(sc.viewProj);
+            if (cacheStatic && (!sc.staticValid || sc.staticVersion != staticVersion || sc.staticViewProj != sc.viewProj))
+                rebuild |= 1u << c;
+        }
+        sliceNear = splitFar[c];
+    }
+    staticRebuilds = 0;
+
+    // camera and light go out once through the uniform buffers, for every pass and program
+    FrameBlock frame;
+    frame.view = view;
+    frame.proj = proj;
+    frame.viewPos = glm::vec4(cameraPos, 1.0f);
+    LightBlock light;
+    for (int c = 0; c < MAX_CASCADES; ++c)
+    {
+        light.cascadeVP[c] = cascades[c].viewProj;
+        light.cascadeSplits[c] = c < cascadeCount ? splitFar[c] : farZ;
+    }
+    light.lightDir = glm::vec4(sunDir, 0.0f);
+    light.lightColor = glm::vec4(1.0f, 0.98f, 0.9f, 1.2f);
+    light.shadowParams = glm::ivec4(shadowPass ? cascadeCount : 0, 0, 0, 0);
+    UploadFrameBlocks(frame, light);
+
+    GLint prevViewport[4];
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+
+    // transforms blended between the last two sim ticks
+    glm::mat4 playerRenderMatrix = game.PlayerModelMatrix(game.RenderPlayerPos());
+
+    // visibility: camera frustum gates the main pass, each cascade's ortho volume its shadow pass
+    Frustum viewFrustum = FrustumFromMatrix(proj * view);
+    const Frustum *viewCull = frustumCulling ? &viewFrustum : nullptr;
+    mainCull = CullStats();
+    shadowCull = CullStats();
+
+    GatherInstances(game);
+    CullInstances(viewFrustum, cascadeFrusta, due);
+    // stream per-instance data once; each pass draws from its own culled range
+    if (instancedFalling)
+        UploadFallingInstances(due);
+
+    /* =========================================================
+       2. Build the frame's draw list (cascade passes + main pass)
+       ========================================================= */
+    drawList.Clear();
+    // floor and player: each mesh is tested against every volume. Static casters only go
+    // into the cascades rebuilding their cached layer (every due cascade without the cache).
+    auto submit = [&](const StaticModel &model, const glm::mat4 &m, bool isStatic)
+    {
+        uint32_t t = drawList.AddTransform(m);
+        float depth = glm::length(glm::vec3(m[3]) - cameraPos);
+        for (int c = 0; c < cascadeCount; ++c)
+        {
+            if (!(due & (1u << c)))
+                continue;
+            DrawPass pass = ShadowPass(c);
+            if (isStatic && cacheStatic)
+            {
+                if (!(rebuild & (1u << c)))
+                    continue;
+                pass = StaticShadowPass(c);
+            }
+            model.Submit(drawList, pass, *shadowShader, t, 0, 0.0f,
+                         frustumCulling ? &cascadeFrusta[c] : nullptr, &shadowCull);
+        }
+        model.Submit(drawList, DRAW_PASS_MAIN, shader3D, t, 0, depth, viewCull, &mainCull);
+    };
+
+    submit(floorModel, game.floorModel.modelMatrix, true); // 已在初始化阶段算好
+    submit(playerModel, playerRenderMatrix, false);
+
+    if (instancedFalling)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            GLsizei count = (GLsizei)instanceData[i].size();
+            for (int c = 0; c < cascadeCount; ++c)
+            {
+                if (shadowCount[i][c])
+                    fallingModels[i].Submit(drawList, ShadowPass(c), *shadowShader, 0, (GLsizei)shadowCount[i][c], 0.0f);
+            }
+            if (count)
+                fallingModels[i].Submit(drawList, DRAW_PASS_MAIN, shader3D, 0, count, 0.0f);
+        }
+    }
+    else
+    {
+        // one draw per visible object, already culled by its bounding sphere
+        for (size_t k = 0; k < worldInstances.size(); ++k)
+        {
+            unsigned int inShadow = 0;
+            for (int c = 0; c < cascadeCount; ++c)
+            {
+                if ((due & (1u << c)) && visibleShadow[c][k])
+                    inShadow |= 1u << c;
+            }
+            if (!visibleMain[k] && !inShadow)
+                continue;
+            const glm::mat4 &m = worldInstances[k].model;
+            const StaticModel &model = fallingModels[worldModel[k]];
+            uint32_t t = drawList.AddTransform(m);
+            for (int c = 0; c < cascadeCount; ++c)
+            {
+                if (inShadow & (1u << c))
+                    model.Submit(drawList, ShadowPass(c), *shadowShader, t, 0, 0.0f);
+            }
+            if (visibleMain[k])
+                model.Submit(drawList, DRAW_PASS_MAIN, shader3D, t, 0, glm::length(glm::vec3(m[3]) - cameraPos));
+        }
+    }
+    drawList.Sort();
+
+    /* =========================================================
+       3. Shadow Pass（只画深度，只画真实模型）—— due cascades only
+       ========================================================= */
+    if (due)
+    {
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(2.0f, 4.0f);
+
+        for (int c = 0; c < cascadeCount; ++c)
+        {
+            if (!(due & (1u << c)))
+                continue;
+            ShadowCascade &sc = cascades[c];
+            glViewport(0, 0, sc.size, sc.size);
+            shadowShader->use();
+            shadowShader->setInt(uCascade, c);
+
+            if (rebuild & (1u << c))
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, sc.staticFbo);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                drawList.Execute(StaticShadowPass(c));
+                sc.staticViewProj = sc.viewProj;
+                sc.staticVersion = staticVersion;
+                sc.staticValid = true;
+                ++staticRebuilds;
+            }
+
+            // start from the cached static depth instead of a cleared map
+            if (cacheStatic)
+            {
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, sc.staticFbo);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, sc.fbo);
+                glBlitFramebuffer(0, 0, sc.size, sc.size, 0, 0, sc.size, sc.size, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+                glBindFramebuffer(GL_FRAMEBUFFER, sc.fbo);
+            }
+            else
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, sc.fbo);
+                glClear(GL_DEPTH_BUFFER_BIT);
+            }
+
+            // instanced casters of this cascade start partway into the shared buffer
+            if (instancedFalling)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    if (shadowCount[i][c])
+                        fallingModels[i].SetDepthInstanceOffset(shadowInstanceVBO[i], shadowFirst[i][c]);
+                }
+            }
+            drawList.Execute(ShadowPass(c));
+            sc.rendered = true;
+        }
+
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(prevViewport[0], prevViewport[1],
+                   prevViewport[2], prevViewport[3]);
+    }
+    ++frameIndex;
+
+    /* =========================================================
+       4. Main Pass（正常渲染）
+       ========================================================= */
+    shader3D.use();
+
+    /* ---- shadow maps: cascade c on texture unit 3 + c ---- */
+    for (int c = 0; c < MAX_CASCADES; ++c)
+    {
+        glActiveTexture(GL_TEXTURE3 + c);
+        glBindTexture(GL_TEXTURE_2D, c < cascadeCount ? cascades[c].depthMap : 0);
+        shader3D.setInt(uShadowMaps[c], 3 + c);
+    }
+    glEnableVertexAttribArray(1); // normal attribute
+
+    // opaque front to back, then hair/alpha meshes back to front
+    drawList.Execute(DRAW_PASS_MAIN);
+}
@@ -0,0 +1,155 @@
+// src/GameRenderer.h
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "StaticModel.h"
+#include "Shader.h"
+#include "UniformBlocks.h"
+#include "DrawList.h"
+#include "Culling.h"
+
+class Game;
+
+// Shadow filter presets: how many hardware-PCF taps phong.fs takes per fragment. Each tap is
+// already a bilinear 2x2 depth compare; the Poisson sets are rotated per pixel.
+enum ShadowQuality
+{
+    SHADOW_QUALITY_LOW = 0,    // 1 tap
+    SHADOW_QUALITY_MEDIUM = 1, // 4 taps on a 2x2 grid
+    SHADOW_QUALITY_HIGH = 2,   // 8-tap Poisson disk
+    SHADOW_QUALITY_ULTRA = 3,  // 16-tap Poisson disk
+};
+
+// "#define SHADOW_TAPS n" for the preset, to build phong.fs with (see Shader's defines)
+std::string ShadowQualityDefines(ShadowQuality quality);
+// "low", "medium", "high" or "ultra"; false (quality untouched) for anything else
+bool ShadowQualityFromName(const char *name, ShadowQuality &quality);
+
+// GL side of the game: uploads the models loaded by Game and draws its current state.
+// Game itself never touches OpenGL, so it can run in the headless HelloGLSim build.
+class GameRenderer
+{
+public:
+    // Upload floor/player/falling models from game (they must have been loaded with geometry)
+    // in vertexFormat, and report the bytes uploaded
+    bool Init(const Game &game);
+    void InitShadowMap();
+    void Render(const Game &game, const Shader &shader3D, const glm::mat4 &view, const glm::mat4 &proj,
+                const glm::vec3 &cameraPos);
+    void SetCubeVAO(unsigned int vao) { cubeVAO = vao; }
+
+    // layout of every uploaded mesh; phong.vs must be built with VertexFormatDefines(vertexFormat)
+    VertexFormat vertexFormat;
+    // vertex + index bytes on the GPU after Init
+    size_t GeometryBytes() const;
+
+    StaticModel floorModel;
+    StaticModel playerModel;
+    StaticModel fallingModels[3];
+
+    // ===== Shadow mapping =====
+    // Cascaded sun shadows: the camera frustum, out to shadowDistance, is cut into
+    // cascadeCount slices and each gets its own depth map fitted around it. Near cascades
+    // get the texels where they are most visible; far ones can be smaller and re-rendered
+    // less often. Set these before InitShadowMap.
+    struct CascadeSettings
+    {
+        unsigned int size;  // depth map width/height
+        int updateInterval; // re-render every N frames (1 = every frame)
+    };
+    int cascadeCount = 3;
+    CascadeSettings cascadeSettings[MAX_CASCADES] = {{2048, 1}, {2048, 1}, {1024, 2}, {1024, 4}};
+    float cascadeSplitLambda = 0.75f; // 0 = uniform splits, 1 = logarithmic
+    float shadowDistance = 60.0f;     // no shadows beyond this view distance
+    float casterDistance = 40.0f;     // how far toward the sun casters outside a slice are caught
+
+    // Static casters (the floor) go into a cached depth layer per cascade, which is copied in
+    // before the dynamic casters (player, falling objects, props) are drawn on top. A layer is
+    // rebuilt only when its cascade's matrix changes (light direction, or the camera leaving a
+    // snap step) or the static geometry does (floor moved, or InvalidateStaticShadows).
+    bool staticShadowCache = true;
+    unsigned int staticCacheSnap = 64; // with the cache on, cascade boxes move in steps of this many texels
+    void InvalidateStaticShadows() { ++staticVersion; }
+    // static layers rebuilt in the last frame
+    unsigned int StaticShadowRebuilds() const { return staticRebuilds; }
+
+    // shadow shader program
+    const Shader *shadowShader = nullptr;
+
+    // draw falling objects with one instanced call per mesh instead of one draw per object
+    bool instancedFalling = true;
+
+    // binds and state changes of the last rendered frame, and how many the sorted list saved
+    const DrawListStats &DrawStats() const { return drawList.Stats(); }
+
+    // skip objects/meshes outside the camera frustum (main pass) or a cascade's light volume
+    // (its shadow pass)
+    bool frustumCulling = true;
+    // last frame's visibility tests: falling/prop instances by bounding sphere, floor and
+    // player meshes by world box; the shadow stats add up every cascade rendered that frame
+    const CullStats &MainCullStats() const { return mainCull; }
+    const CullStats &ShadowCullStats() const { return shadowCull; }
+
+private:
+    unsigned int cubeVAO = 0;
+
+    struct ShadowCascade
+    {
+        unsigned int fbo = 0;
+        unsigned int depthMap = 0;
+        unsigned int size = 0;
+        glm::mat4 viewProj = glm::mat4(1.0f); // what the map was last rendered with
+        bool rendered = false;
+        // cached static layer and what it was rendered with
+        unsigned int staticFbo = 0;
+        unsigned int staticMap = 0;
+        glm::mat4 staticViewProj = glm::mat4(1.0f);
+        unsigned int staticVersion = 0;
+        bool staticValid = false;
+    };
+    ShadowCascade cascades[MAX_CASCADES];
+    unsigned int frameIndex = 0;
+    unsigned int staticVersion = 0;
+    unsigned int staticRebuilds = 0;
+    glm::mat4 staticFloorMatrix = glm::mat4(0.0f);
+    // which cascades re-render this frame (bit per cascade)
+    unsigned int DueCascades() const;
+
+    // ===== Per-frame uniform buffers =====
+    // camera and sun data, written once per frame and read by every program through
+    // the FrameData/LightData blocks (see UniformBlocks.h)
+    unsigned int frameUBO = 0;
+    unsigned int lightUBO = 0;
+    void InitUniformBuffers();
+    void UploadFrameBlocks(const FrameBlock &frame, const LightBlock &light);
+
+    // ===== Falling objects and props =====
+    // world transform, tint, model and bounding sphere (SoA, for the batched cull) of every
+    // instance this frame, rebuilt from the interpolated sim state
+    std::vector<InstanceData> worldInstances;
+    std::vector<uint8_t> worldModel;
+    std::vector<float> sphereX, sphereY, sphereZ, sphereR;
+    std::vector<uint8_t> visibleMain, visibleShadow[MAX_CASCADES];
+    void GatherInstances(const Game &game);
+    void CullInstances(const Frustum &view, const Frustum *cascadeFrusta, unsigned int due);
+
+    // ===== Instanced falling objects =====
+    // per falling model: one streamed buffer of main-pass instances and one of shadow casters,
+    // each holding only the instances that passed that pass's cull. The shadow buffer holds
+    // the casters of every due cascade back to back, from shadowFirst[model][cascade] on.
+    unsigned int instanceVBO[3] = {0, 0, 0};
+    unsigned int shadowInstanceVBO[3] = {0, 0, 0};
+    size_t instanceCapacity[3] = {0, 0, 0};
+    size_t shadowInstanceCapacity[3] = {0, 0, 0};
+    std::vector<InstanceData> instanceData[3];
+    std::vector<InstanceData> shadowInstanceData[3];
+    size_t shadowFirst[3][MAX_CASCADES] = {};
+    size_t shadowCount[3][MAX_CASCADES] = {};
+    void UploadFallingInstances(unsigned int due);
+
+    CullStats mainCull, shadowCull;
+
+    // main and cascade passes are queued here, sorted once and executed pass by pass
+    DrawList drawList;
+};
@@ -0,0 +1,84 @@
+#include "MemStats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> s_allocations{0};
+
+uint64_t HeapAllocationCount()
+{
+    return s_allocations.load(std::memory_order_relaxed);
+}
+
+static void *CountedAlloc(std::size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+static void *CountedAlignedAlloc(std::size_t size, std::size_t align)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (align < sizeof(void *))
+        align = sizeof(void *);
+#ifdef _WIN32
+    void *p = _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc requires size to be a multiple of the alignment
+    std::size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+    void *p = std::aligned_alloc(align, rounded);
+#endif
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+static void AlignedFree(void *p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void *operator new(std::size_t size) { return CountedAlloc(size); }
+void *operator new[](std::size_t size) { return CountedAlloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return CountedAlloc(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return CountedAlloc(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+void *operator new(std::size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, (std::size_t)align); }
+void *operator new[](std::size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, (std::size_t)align); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { AlignedFree(p); }
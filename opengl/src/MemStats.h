@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+
+// Process-wide heap allocation counter. MemStats.cpp replaces the global operator new
+// family so every allocation (ours and third-party) bumps it; query deltas around a
+// block of work to confirm it is allocation-free.
+uint64_t HeapAllocationCount();
@@ -0,0 +1,313 @@
+// src/ModelData.cpp
+#include "ModelData.h"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <chrono>
+#include <iostream>
+#include <cctype>
+
+static glm::vec3 aiVec3ToGlm(const aiVector3D &v) { return glm::vec3(v.x, v.y, v.z); }
+static glm::vec2 aiVec2ToGlm(const aiVector3D &v) { return glm::vec2(v.x, v.y); }
+
+// Helper function to normalize path separators
+static std::string NormalizePath(const std::string &path)
+{
+    std::string result = path;
+#ifdef _WIN32
+    // On Windows, replace / with \ for consistency
+    for (size_t i = 0; i < result.length(); ++i)
+    {
+        if (result[i] == '/')
+            result[i] = '\\';
+    }
+#else
+    // On Unix/Mac, replace \ with / for consistency
+    for (size_t i = 0; i < result.length(); ++i)
+    {
+        if (result[i] == '\\')
+            result[i] = '/';
+    }
+#endif
+    return result;
+}
+
+// Where to look for a diffuse texture referenced by the material, in priority order
+static std::vector<std::string> DiffuseCandidates(const std::string &directory, const std::string &texFile)
+{
+    std::vector<std::string> out;
+
+    // Check if it's an absolute path (works on both Windows and Unix/Mac)
+    // Unix/Mac absolute path: starts with / (check this first, works on all platforms)
+    // Windows absolute path: C:\ or D:\ etc. (or C:/ or D:/)
+    bool isAbsolute = texFile[0] == '/';
+#ifdef _WIN32
+    if (!isAbsolute && texFile.length() >= 3 && texFile[1] == ':' && (texFile[2] == '\\' || texFile[2] == '/'))
+        isAbsolute = true;
+#endif
+
+    if (!isAbsolute)
+    {
+        // Relative path: make absolute relative to model directory
+        out.push_back(directory + "/" + texFile);
+        return out;
+    }
+
+    // Extract filename from absolute path
+    size_t lastSlash = texFile.find_last_of("/\\");
+    std::string filename = (lastSlash == std::string::npos) ? texFile : texFile.substr(lastSlash + 1);
+
+    // 1. First try in model directory (same directory as .obj file)
+#ifdef _WIN32
+    out.push_back(NormalizePath(directory + "\\" + filename));
+#else
+    out.push_back(NormalizePath(directory + "/" + filename));
+#endif
+
+    // 2. If not found, try in blender directory (common case)
+    // Find project root by looking for "opengl" in directory path
+    size_t openglPos = directory.find("opengl");
+    if (openglPos != std::string::npos)
+    {
+        std::string projectRoot = directory.substr(0, openglPos);
+#ifdef _WIN32
+        out.push_back(NormalizePath(projectRoot + "Model\\textures\\" + filename));
+#else
+        out.push_back(NormalizePath(projectRoot + "Model/textures/" + filename));
+#endif
+    }
+
+    // 3. Try in assets/models directory
+    size_t assetsPos = directory.find("assets");
+    if (assetsPos != std::string::npos)
+    {
+        std::string baseDir = directory.substr(0, assetsPos);
+#ifdef _WIN32
+        out.push_back(NormalizePath(baseDir + "assets\\models\\" + filename));
+#else
+        out.push_back(NormalizePath(baseDir + "assets/models/" + filename));
+#endif
+    }
+    return out;
+}
+
+static bool ContainsHairOrFur(std::string s)
+{
+    for (auto &c : s)
+        c = (char)tolower(c);
+    return s.find("hair") != std::string::npos || s.find("fur") != std::string::npos;
+}
+
+bool ModelData::LoadFromFile(const std::string &path, bool keepGeometry)
+{
+    meshes.clear();
+
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(path,
+                                             aiProcess_Triangulate |
+                                                 aiProcess_GenSmoothNormals |
+                                                 aiProcess_FlipUVs |
+                                                 aiProcess_CalcTangentSpace |
+                                                 aiProcess_JoinIdenticalVertices |
+                                                 aiProcess_OptimizeMeshes |
+                                                 aiProcess_PreTransformVertices // bake node transforms into vertices -> simpler
+    );
+
+    if (!scene || !scene->HasMeshes())
+    {
+        std::cerr << "ModelData: failed to load " << path << " (" << importer.GetErrorString() << ")\n";
+        return false;
+    }
+
+    // directory for relative texture paths
+    size_t p = path.find_last_of("/\\");
+    directory = (p == std::string::npos) ? "." : path.substr(0, p);
+
+    // For each mesh, collect vertex/index data and material
+    meshes.resize(scene->mNumMeshes);
+
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+    {
+        aiMesh *mesh = scene->mMeshes[m];
+        MeshData &dst = meshes[m];
+        dst.vertices.resize(mesh->mNumVertices);
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
+        {
+            SimpleVertex &v = dst.vertices[i];
+            v.pos = aiVec3ToGlm(mesh->mVertices[i]);
+            v.normal = mesh->HasNormals() ? aiVec3ToGlm(mesh->mNormals[i]) : glm::vec3(0, 1, 0);
+            if (mesh->mTextureCoords[0])
+                v.uv = aiVec2ToGlm(mesh->mTextureCoords[0][i]);
+            else
+                v.uv = glm::vec2(0.0f, 0.0f);
+        }
+        dst.indices.reserve(mesh->mNumFaces * 3);
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f)
+        {
+            const aiFace &face = mesh->mFaces[f];
+            if (face.mNumIndices != 3)
+                continue;
+            dst.indices.push_back(face.mIndices[0]);
+            dst.indices.push_back(face.mIndices[1]);
+            dst.indices.push_back(face.mIndices[2]);
+        }
+
+        // material handling
+        if (scene->mNumMaterials == 0 || mesh->mMaterialIndex >= scene->mNumMaterials)
+            continue;
+        aiMaterial *mat = scene->mMaterials[mesh->mMaterialIndex];
+
+        // diffuse color (fallback)
+        aiColor3D col(1.0f, 1.0f, 1.0f);
+        if (AI_SUCCESS == mat->Get(AI_MATKEY_COLOR_DIFFUSE, col))
+            dst.diffuseColor = glm::vec3(col.r, col.g, col.b);
+
+        // diffuse texture
+        if (mat->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        {
+            aiString texPath;
+            mat->GetTexture(aiTextureType_DIFFUSE, 0, &texPath);
+            std::string texFile = texPath.C_Str();
+
+            // Skip embedded textures (GLB files use *0, *1, etc. as placeholders)
+            if (texFile.empty() || texFile[0] == '*')
+            {
+                std::cout << "ModelData: skipping embedded texture placeholder: " << texFile << "\n";
+            }
+            else
+            {
+                dst.diffuseCandidates = DiffuseCandidates(directory, texFile);
+                // heuristic: texture filename containing "hair" or "fur" marks hair
+                if (ContainsHairOrFur(texFile))
+                {
+                    dst.isHair = true;
+                    dst.alphaCutoff = 0.4f;
+                }
+            }
+        }
+
+        // opacity or transparency detection
+        float opacity = 1.0f;
+        if (AI_SUCCESS == aiGetMaterialFloat(mat, AI_MATKEY_OPACITY, &opacity))
+        {
+            if (opacity < 0.999f)
+                dst.opacityAlpha = true;
+        }
+
+        // heuristic: if material name contains "hair" or "fur", mark as hair
+        aiString matName;
+        if (AI_SUCCESS == mat->Get(AI_MATKEY_NAME, matName) && ContainsHairOrFur(matName.C_Str()))
+        {
+            dst.isHair = true;
+            dst.alphaCutoff = 0.4f;
+        }
+    }
+
+    bboxInitialized = false;
+    ComputeBBoxRecursive(scene->mRootNode, scene, glm::mat4(1.0f));
+    ComputeCollision(path);
+
+    if (!keepGeometry)
+        ReleaseGeometry();
+    return true;
+}
+
+void ModelData::ReleaseGeometry()
+{
+    for (auto &m : meshes)
+    {
+        std::vector<SimpleVertex>().swap(m.vertices);
+        std::vector<unsigned int>().swap(m.indices);
+    }
+}
+
+void ModelData::ComputeCollision(const std::string &path)
+{
+    collision = ModelCollision();
+    collision.box = MakeLocalBox(bboxMin, bboxMax);
+
+    // vertices are pre-transformed into model space (aiProcess_PreTransformVertices)
+    std::vector<glm::vec3> points;
+    collision.meshBox.reserve(meshes.size());
+    for (const MeshData &m : meshes)
+    {
+        if (m.vertices.empty())
+        {
+            collision.meshBox.push_back(LocalBox());
+            continue;
+        }
+        glm::vec3 lo = m.vertices[0].pos, hi = m.vertices[0].pos;
+        for (const SimpleVertex &v : m.vertices)
+        {
+            lo = glm::min(lo, v.pos);
+            hi = glm::max(hi, v.pos);
+            points.push_back(v.pos);
+        }
+        collision.meshBox.push_back(MakeLocalBox(lo, hi));
+    }
+    collision.sphere = ComputeBoundingSphere(points);
+
+    // quickhull over a large mesh is the slow part of loading, so the result is cached on
+    // disk and only rebuilt when the vertices change
+    if (points.empty())
+        return;
+    std::string cachePath = path + ".hull";
+    uint64_t hash = HullSourceHash(points, HULL_MAX_VERTICES);
+    if (LoadHullCache(cachePath, hash, collision.hull))
+        return;
+    auto t0 = std::chrono::steady_clock::now();
+    int exactVertices = 0;
+    collision.hull = BuildConvexHull(points, HULL_MAX_VERTICES, &exactVertices);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "ModelData: convex hull of " << path << ": " << points.size() << " vertices -> "
+              << exactVertices << " on hull -> " << collision.hull.points.size() << " kept ("
+              << ms << " ms)\n";
+    if (!SaveHullCache(cachePath, hash, collision.hull))
+        std::cout << "ModelData: could not write hull cache " << cachePath << "\n";
+}
+
+static glm::mat4 aiMatToGlm(const aiMatrix4x4 &m)
+{
+    return glm::mat4(
+        m.a1, m.b1, m.c1, m.d1,
+        m.a2, m.b2, m.c2, m.d2,
+        m.a3, m.b3, m.c3, m.d3,
+        m.a4, m.b4, m.c4, m.d4);
+}
+
+void ModelData::ComputeBBoxRecursive(
+    aiNode *node,
+    const aiScene *scene,
+    const glm::mat4 &parentTransform)
+{
+    glm::mat4 nodeTransform = parentTransform * aiMatToGlm(node->mTransformation);
+
+    // 遍历该 node 挂载的 mesh
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i)
+    {
+        aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v)
+        {
+            glm::vec3 p = aiVec3ToGlm(mesh->mVertices[v]);
+            glm::vec4 worldP = nodeTransform * glm::vec4(p, 1.0f);
+            glm::vec3 wp(worldP);
+
+            if (!bboxInitialized)
+            {
+                bboxMin = bboxMax = wp;
+                bboxInitialized = true;
+            }
+            else
+            {
+                bboxMin = glm::min(bboxMin, wp);
+                bboxMax = glm::max(bboxMax, wp);
+            }
+        }
+    }
+
+    // 递归子节点
+    for (unsigned int c = 0; c < node->mNumChildren; ++c)
+    {
+        ComputeBBoxRecursive(node->mChildren[c], scene, nodeTransform);
+    }
+}
@@ -0,0 +1,60 @@
+// src/ModelData.h
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Collision.h"
+
+struct aiNode;
+struct aiScene;
+
+struct SimpleVertex
+{
+    glm::vec3 pos;
+    glm::vec3 normal;
+    glm::vec2 uv;
+};
+
+// CPU-side mesh: geometry plus the material description needed to build GPU resources
+struct MeshData
+{
+    std::vector<SimpleVertex> vertices;
+    std::vector<unsigned int> indices;
+
+    glm::vec3 diffuseColor = glm::vec3(1.0f);
+    // texture files to try in order (first one that loads wins); empty = untextured
+    std::vector<std::string> diffuseCandidates;
+    bool opacityAlpha = false; // material opacity < 1
+    bool isHair = false;       // treat as hair: alpha + alpha cutoff + blending
+    float alphaCutoff = 0.5f;  // default alpha cutoff for alpha-test
+};
+
+// Model loaded via Assimp without touching OpenGL. The simulation only needs the bounds;
+// StaticModel::Upload turns the geometry into VAOs/textures when a GL context exists.
+class ModelData
+{
+public:
+    // keepGeometry = false drops vertex/index arrays after load (bounds are kept)
+    bool LoadFromFile(const std::string &path, bool keepGeometry = true);
+    void ReleaseGeometry();
+
+    std::vector<MeshData> meshes;
+    std::string directory;
+
+    // convenience scale
+    glm::vec3 modelScale = glm::vec3(1.0f);
+    glm::mat4 modelMatrix = glm::mat4(1.0f);
+    glm::vec3 bboxMin = glm::vec3(0.0f);
+    glm::vec3 bboxMax = glm::vec3(0.0f);
+    bool bboxInitialized = false;
+
+    // local box, tight sphere, per-mesh boxes and convex hull, filled at load (kept by ReleaseGeometry)
+    ModelCollision collision;
+
+private:
+    // path locates the hull cache file (<path>.hull) next to the model
+    void ComputeCollision(const std::string &path);
+    void ComputeBBoxRecursive(aiNode *node,
+                              const aiScene *scene,
+                              const glm::mat4 &parentTransform);
+};
@@ -0,0 +1,47 @@
+#include "Paths.h"
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#include <stdlib.h>
+#include <unistd.h>
+#elif _WIN32
+#define WIN32_LEAN_AND_MEAN // Reduce Windows.h includes
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+std::string GetExecutableDir()
+{
+#ifdef _WIN32
+    // Windows platform
+    char path[MAX_PATH];
+    GetModuleFileNameA(NULL, path, MAX_PATH);
+    std::string full(path);
+    size_t pos = full.find_last_of("\\/");
+    return full.substr(0, pos);
+#elif __APPLE__
+    // macOS platform
+    char path[1024];
+    uint32_t size = sizeof(path);
+    _NSGetExecutablePath(path, &size);
+
+    char resolved[1024];
+    realpath(path, resolved);
+
+    std::string full(resolved);
+    size_t pos = full.find_last_of("/");
+    return full.substr(0, pos);
+#else
+    // Linux platform
+    char path[PATH_MAX];
+    ssize_t count = readlink("/proc/self/exe", path, PATH_MAX);
+    if (count != -1)
+    {
+        std::string full(path);
+        size_t pos = full.find_last_of("/");
+        return full.substr(0, pos);
+    }
+    return ".";
+#endif
+}
@@ -0,0 +1,6 @@
+// src/Paths.h
+#pragma once
+#include <string>
+
+// Directory containing the running executable (shaders/ and assets/ are copied next to it)
+std::string GetExecutableDir();
@@ -1,4 +1,5 @@
-#include <glad/glad.h>
+// only the key codes are used here; no GL header and no GLFW linkage needed
+#define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <chrono>
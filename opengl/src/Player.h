@@ -6,6 +6,7 @@ class Player
 {
 public:
     glm::vec3 pos;
+    glm::vec3 prevPos; // position at the start of the current sim tick (render interpolation)
     glm::vec3 color;
     glm::mat4 modelMatrix;
     float moveSpeed = 5.0f;
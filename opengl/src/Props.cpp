@@ -0,0 +1,251 @@
+// src/Props.cpp
+#include "Props.h"
+#include "Transform.h"
+#include <algorithm>
+
+void PropSet::SetCapacity(size_t n)
+{
+    cap = n;
+    auto reserve = [&](auto &a)
+    {
+        a.clear();
+        a.shrink_to_fit();
+        a.reserve(n);
+    };
+    reserve(pos); reserve(prevPos); reserve(vel);
+    reserve(orientation); reserve(sphereOffset); reserve(radius); reserve(bottomOffset);
+    reserve(modelScale); reserve(color); reserve(modelMatrix); reserve(modelIndex);
+    reserve(asleep); reserve(stillAnchor); reserve(stillTicks);
+    reserve(awake); reserve(touching);
+    awakeSlot.assign(n, 0);
+    // a resting prop seldom touches more than a handful of neighbours
+    contacts.reserve(n * 8);
+    candidates.reserve(256);
+
+    // sleepers never move, so a tree (only awake leaves are ever updated) beats rebuilding a grid
+    broadphase = CreateBroadphase(BroadphaseType::AABBTree);
+    broadphase->Reserve(n);
+    clear();
+}
+
+void PropSet::clear()
+{
+    pos.clear(); prevPos.clear(); vel.clear();
+    orientation.clear(); sphereOffset.clear(); radius.clear(); bottomOffset.clear();
+    modelScale.clear(); color.clear(); modelMatrix.clear(); modelIndex.clear();
+    asleep.clear(); stillAnchor.clear(); stillTicks.clear();
+    awake.clear();
+    touching.clear();
+    broadphase->Clear();
+    topY = -INFINITY;
+}
+
+bool PropSet::Add(const glm::vec3 &p, const glm::quat &q, const glm::vec3 &v, const glm::vec3 &scale,
+                  const glm::vec3 &tint, int model, const LocalBox &box)
+{
+    if (full())
+        return false;
+
+    glm::mat3 rot = QuatToMat3(q);
+    OBB obb = WorldOBB(box, p, rot, scale);
+    AABB bounds = OBBBounds(obb);
+
+    uint32_t i = (uint32_t)size();
+    pos.push_back(p);
+    prevPos.push_back(p);
+    vel.push_back(v);
+    orientation.push_back(q);
+    sphereOffset.push_back(obb.center - p);
+    // mean half extent: fatter than the thinnest side, slimmer than the bounding sphere
+    radius.push_back((obb.half[0] + obb.half[1] + obb.half[2]) / 3.0f);
+    bottomOffset.push_back(bounds.min.y - p.y);
+    modelScale.push_back(scale);
+    color.push_back(tint);
+    modelMatrix.push_back(ComposeTRS(p, rot, scale));
+    modelIndex.push_back(model);
+    asleep.push_back(1);
+    stillAnchor.push_back(p);
+    stillTicks.push_back(0);
+    touching.push_back(0);
+
+    broadphase->Insert(i, SphereBounds(i));
+    Wake(i);
+    topY = std::max(topY, SphereBounds(i).max.y);
+    return true;
+}
+
+void PropSet::Wake(uint32_t i)
+{
+    if (!asleep[i])
+        return;
+    asleep[i] = 0;
+    stillAnchor[i] = pos[i];
+    stillTicks[i] = 0;
+    touching[i] = 0;
+    awakeSlot[i] = (uint32_t)awake.size();
+    awake.push_back(i);
+}
+
+void PropSet::Sleep(uint32_t i)
+{
+    asleep[i] = 1;
+    vel[i] = glm::vec3(0.0f);
+    prevPos[i] = pos[i];
+    uint32_t s = awakeSlot[i];
+    awake[s] = awake.back();
+    awakeSlot[awake[s]] = s;
+    awake.pop_back();
+}
+
+void PropSet::Step(float dt, float gravity, float floorTop)
+{
+    if (awake.empty())
+        return;
+
+    // 1) integrate awake props
+    for (uint32_t i : awake)
+    {
+        prevPos[i] = pos[i];
+        vel[i].y += gravity * dt;
+        pos[i] += vel[i] * dt;
+        touching[i] = 0;
+        broadphase->Update(i, SphereBounds(i));
+    }
+
+    // 2) contacts of every awake prop; a pair of awake props is listed once
+    contacts.clear();
+    for (uint32_t i : awake)
+    {
+        candidates.clear();
+        broadphase->QueryAABB(SphereBounds(i), candidates);
+        for (ProxyId j : candidates)
+        {
+            if (j == i || (!asleep[j] && j < i))
+                continue;
+            contacts.push_back({i, j});
+        }
+    }
+
+    // 3) relax penetrations; sleepers act as static unless pushed hard enough to wake
+    for (int it = 0; it < solverIterations; ++it)
+    {
+        for (const Contact &c : contacts)
+        {
+            glm::vec3 d = (pos[c.a] + sphereOffset[c.a]) - (pos[c.b] + sphereOffset[c.b]);
+            float reach = radius[c.a] + radius[c.b];
+            float dist2 = glm::dot(d, d);
+            if (dist2 >= reach * reach)
+                continue;
+            float dist = std::sqrt(dist2);
+            glm::vec3 n = (dist > 1e-6f) ? d / dist : glm::vec3(0.0f, 1.0f, 0.0f);
+            float depth = reach - dist;
+            if (asleep[c.b] && depth > wakePenetration)
+                Wake(c.b);
+
+            float wb = asleep[c.b] ? 0.0f : 0.5f;
+            pos[c.a] += n * (depth * (1.0f - wb));
+            pos[c.b] -= n * (depth * wb);
+            touching[c.a] = touching[c.b] = 1;
+        }
+        for (uint32_t i : awake)
+        {
+            float minY = floorTop - bottomOffset[i];
+            if (pos[i].y < minY)
+            {
+                pos[i].y = minY;
+                touching[i] = 1;
+            }
+        }
+    }
+
+    // 4) velocities from the corrected positions, friction, sleeping
+    const float still2 = sleepRadius * sleepRadius;
+    for (size_t k = awake.size(); k-- > 0;)
+    {
+        uint32_t i = awake[k];
+        // props woken during this Step kept prevPos from when they fell asleep, so the push
+        // they received becomes their velocity
+        vel[i] = (pos[i] - prevPos[i]) / dt;
+        if (touching[i])
+        {
+            vel[i].x *= 1.0f - friction;
+            vel[i].z *= 1.0f - friction;
+        }
+        // deep overlaps resolved in one tick would otherwise turn into a launch
+        float speed2 = glm::dot(vel[i], vel[i]);
+        if (speed2 > maxSpeed * maxSpeed)
+            vel[i] *= maxSpeed / std::sqrt(speed2);
+
+        // stillness is judged on net displacement, not speed: a prop pressed against sleepers
+        // gets the whole correction and can be pushed back and forth every tick without
+        // getting anywhere
+        glm::vec3 drift = pos[i] - stillAnchor[i];
+        if (glm::dot(drift, drift) < still2)
+        {
+            if (++stillTicks[i] >= sleepTicks)
+                Sleep(i); // swaps awake.back() into k, which was already visited
+        }
+        else
+        {
+            stillAnchor[i] = pos[i];
+            stillTicks[i] = 0;
+        }
+
+        modelMatrix[i] = ComposeTRS(pos[i], QuatToMat3(orientation[i]), modelScale[i]);
+        AABB b = SphereBounds(i);
+        broadphase->Update(i, b);
+        topY = std::max(topY, b.max.y);
+    }
+}
+
+bool PropSet::TouchesSphere(const glm::vec3 &center, float r)
+{
+    if (pos.empty() || center.y - r > topY)
+        return false;
+    candidates.clear();
+    broadphase->QueryAABB({center - glm::vec3(r), center + glm::vec3(r)}, candidates);
+    for (ProxyId j : candidates)
+    {
+        glm::vec3 d = center - (pos[j] + sphereOffset[j]);
+        float reach = r + radius[j];
+        if (glm::dot(d, d) < reach * reach)
+            return true;
+    }
+    return false;
+}
+
+glm::vec3 PropSet::PushOutCylinder(glm::vec3 base, float r, float height)
+{
+    if (pos.empty() || base.y > topY)
+        return base;
+    // two passes settle the player between neighbouring props
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        candidates.clear();
+        broadphase->QueryAABB({base - glm::vec3(r, 0.0f, r), base + glm::vec3(r, height, r)}, candidates);
+        for (ProxyId j : candidates)
+        {
+            glm::vec3 c = pos[j] + sphereOffset[j];
+            // horizontal radius of the sphere's slice nearest the cylinder's span
+            float dy = std::max({base.y - c.y, c.y - (base.y + height), 0.0f});
+            if (dy >= radius[j])
+                continue;
+            float slice = std::sqrt(radius[j] * radius[j] - dy * dy);
+            glm::vec2 d(base.x - c.x, base.z - c.z);
+            float reach = r + slice;
+            float dist2 = glm::dot(d, d);
+            if (dist2 >= reach * reach)
+                continue;
+            float dist = std::sqrt(dist2);
+            glm::vec2 n = (dist > 1e-6f) ? d / dist : glm::vec2(1.0f, 0.0f);
+            base.x = c.x + n.x * reach;
+            base.z = c.z + n.y * reach;
+        }
+    }
+    return base;
+}
+
+glm::mat4 PropSet::InterpolatedMatrix(size_t i, float alpha) const
+{
+    return ComposeTRS(glm::mix(prevPos[i], pos[i], alpha), QuatToMat3(orientation[i]), modelScale[i]);
+}
@@ -0,0 +1,97 @@
+// src/Props.h
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "Broadphase.h"
+#include "Collision.h"
+
+// Landed objects that stay in the scene, pile up and block the player.
+// Each prop keeps the orientation it landed with and collides as a sphere (sized from its
+// box, centred on the box) against the floor plane and against other props. Contacts are
+// resolved by position projection; props that stay still for a while go to sleep and are
+// skipped entirely until something pushes into them, so a floor full of resting props costs
+// only their entries in the broadphase tree.
+//
+// Props are never removed individually (only by clear), so the index is also the proxy id.
+class PropSet
+{
+public:
+    // ---- per prop ----
+    std::vector<glm::vec3> pos, prevPos, vel;
+    std::vector<glm::quat> orientation;
+    std::vector<glm::vec3> sphereOffset; // contact sphere centre relative to pos (world, fixed)
+    std::vector<float> radius;           // contact sphere radius
+    std::vector<float> bottomOffset;     // lowest point of the box relative to pos.y
+    std::vector<glm::vec3> modelScale;
+    std::vector<glm::vec3> color;
+    std::vector<glm::mat4> modelMatrix;
+    std::vector<int> modelIndex;
+    std::vector<uint8_t> asleep;
+    std::vector<glm::vec3> stillAnchor; // where the prop was when it last started keeping still
+    std::vector<uint16_t> stillTicks;    // consecutive ticks within sleepRadius of stillAnchor
+
+    // ---- tuning ----
+    float friction = 0.5f;          // fraction of sliding speed lost per tick while in contact
+    float sleepRadius = 0.02f;      // props that stay this close to where they stopped count as still
+    int sleepTicks = 20;            // ... and fall asleep after this many still ticks
+    float wakePenetration = 0.05f;  // pushes deeper than this wake a sleeping prop
+    float maxSpeed = 4.0f;          // speed cap after contact resolution
+    int solverIterations = 4;
+
+    explicit PropSet(size_t capacity = 0) { SetCapacity(capacity); }
+
+    // Reserve storage for n props (and their broadphase proxies); drops all props
+    void SetCapacity(size_t n);
+    size_t capacity() const { return cap; }
+    size_t size() const { return pos.size(); }
+    bool full() const { return size() >= cap; }
+    size_t AwakeCount() const { return awake.size(); }
+    void clear();
+
+    // New prop at the given pose, awake and moving with vel; box is the model's local
+    // collision box. Returns false (and adds nothing) when the set is full.
+    bool Add(const glm::vec3 &p, const glm::quat &q, const glm::vec3 &v, const glm::vec3 &scale,
+             const glm::vec3 &tint, int model, const LocalBox &box);
+
+    // One tick for awake props: gravity, floor and prop-prop contacts, friction, sleeping
+    void Step(float dt, float gravity, float floorTop);
+
+    // True if the sphere touches any prop (used to land falling objects on piles)
+    bool TouchesSphere(const glm::vec3 &center, float r);
+    // Push an upright cylinder (the player) out of every prop it overlaps, in the XZ plane only.
+    // Returns the corrected base position.
+    glm::vec3 PushOutCylinder(glm::vec3 base, float r, float height);
+
+    // highest point any prop has reached (props entirely below it are skipped by callers)
+    float TopY() const { return topY; }
+
+    glm::mat4 InterpolatedMatrix(size_t i, float alpha) const;
+
+private:
+    struct Contact
+    {
+        uint32_t a, b;
+    };
+
+    AABB SphereBounds(size_t i) const
+    {
+        glm::vec3 c = pos[i] + sphereOffset[i];
+        return {c - glm::vec3(radius[i]), c + glm::vec3(radius[i])};
+    }
+    void Wake(uint32_t i);
+    void Sleep(uint32_t i);
+
+    size_t cap = 0;
+    float topY = -INFINITY;
+    std::unique_ptr<Broadphase> broadphase;
+    std::vector<uint32_t> awake;       // indices of awake props
+    std::vector<uint32_t> awakeSlot;   // prop -> index in awake (while awake)
+    std::vector<Contact> contacts;     // scratch, rebuilt every Step
+    std::vector<uint8_t> touching;     // scratch: prop had a contact this Step
+    std::vector<ProxyId> candidates;   // scratch for broadphase queries
+};
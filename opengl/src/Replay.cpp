@@ -0,0 +1,165 @@
+#include "Replay.h"
+#include "Game.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static const char REPLAY_MAGIC[4] = {'H', 'G', 'L', 'R'};
+// 2: landed objects stay as props, which changes outcomes of version 1 recordings
+// 3: player hits are confirmed on the model hulls (GJK), so near-misses no longer kill
+// 4: header records the outcome-changing switches (continuousCollision, keepLanded, hullNarrowphase)
+static const uint32_t REPLAY_VERSION = 4;
+
+template <typename T>
+static void WritePod(std::ofstream &out, const T &v)
+{
+    out.write(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+template <typename T>
+static bool ReadPod(std::ifstream &in, T &v)
+{
+    return (bool)in.read(reinterpret_cast<char *>(&v), sizeof(T));
+}
+
+bool ReplayRecorder::Begin(const std::string &path, const Game &game)
+{
+    End();
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Replay: cannot open " << path << " for writing\n";
+        return false;
+    }
+    out.write(REPLAY_MAGIC, 4);
+    WritePod(out, REPLAY_VERSION);
+    WritePod(out, game.seed);
+    WritePod(out, game.simHz);
+    WritePod(out, (int32_t)game.maxSubsteps);
+    uint8_t rules = (game.continuousCollision ? REPLAY_CCD : 0) | (game.keepLanded ? REPLAY_KEEP_LANDED : 0) |
+                    (game.hullNarrowphase ? REPLAY_HULLS : 0);
+    WritePod(out, rules);
+    frames = 0;
+    return true;
+}
+
+void ReplayRecorder::RecordFrame(float dt, const bool keys[1024], const glm::vec3 &cameraFront,
+                                 const glm::vec3 &cameraUp, const Game &game)
+{
+    if (!out.is_open())
+        return;
+    WritePod(out, dt);
+    WritePod(out, cameraFront);
+    WritePod(out, cameraUp);
+
+    uint16_t pressed[255];
+    uint8_t keyCount = 0;
+    for (int k = 0; k < 1024 && keyCount < 255; ++k)
+    {
+        if (keys[k])
+            pressed[keyCount++] = (uint16_t)k;
+    }
+    WritePod(out, keyCount);
+    out.write(reinterpret_cast<const char *>(pressed), keyCount * sizeof(uint16_t));
+
+    WritePod(out, (uint8_t)(game.playerDead ? 1 : 0));
+    WritePod(out, (uint32_t)game.falling.size());
+    ++frames;
+}
+
+void ReplayRecorder::End()
+{
+    if (!out.is_open())
+        return;
+    out.close();
+    std::cout << "Replay: recorded " << frames << " frames\n";
+}
+
+bool RunReplay(const std::string &path, Game &game)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0;
+    if (!in || !in.read(magic, 4) || std::memcmp(magic, REPLAY_MAGIC, 4) != 0 ||
+        !ReadPod(in, version) || version != REPLAY_VERSION)
+    {
+        std::cerr << "Replay: " << path << " is not a version " << REPLAY_VERSION << " recording\n";
+        return false;
+    }
+    uint32_t seed = 0;
+    int32_t maxSubsteps = 0;
+    float simHz = 0.0f;
+    uint8_t rules = 0;
+    ReadPod(in, seed);
+    ReadPod(in, simHz);
+    ReadPod(in, maxSubsteps);
+    ReadPod(in, rules);
+
+    game.simHz = simHz;
+    game.maxSubsteps = maxSubsteps;
+    game.continuousCollision = (rules & REPLAY_CCD) != 0;
+    game.keepLanded = (rules & REPLAY_KEEP_LANDED) != 0;
+    game.hullNarrowphase = (rules & REPLAY_HULLS) != 0;
+    game.fixedSeed = true;
+    game.seed = seed;
+    game.Reset();
+
+    bool keys[1024] = {false};
+    uint32_t frame = 0;
+    long recordedDeath = -1, replayedDeath = -1;
+    long firstMismatch = -1;
+    double simSeconds = 0.0;
+
+    for (;;)
+    {
+        float dt;
+        glm::vec3 front, up;
+        uint8_t keyCount;
+        if (!ReadPod(in, dt))
+            break;
+        ReadPod(in, front);
+        ReadPod(in, up);
+        ReadPod(in, keyCount);
+        uint16_t pressed[255];
+        in.read(reinterpret_cast<char *>(pressed), keyCount * sizeof(uint16_t));
+        uint8_t dead;
+        uint32_t liveObjects;
+        ReadPod(in, dead);
+        if (!ReadPod(in, liveObjects))
+        {
+            std::cerr << "Replay: truncated frame " << frame << "\n";
+            break;
+        }
+
+        std::memset(keys, 0, sizeof(keys));
+        for (int k = 0; k < keyCount; ++k)
+        {
+            if (pressed[k] < 1024)
+                keys[pressed[k]] = true;
+        }
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        game.Advance(dt, keys, front, up);
+        simSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+
+        if (dead && recordedDeath < 0)
+            recordedDeath = frame;
+        if (game.playerDead && replayedDeath < 0)
+            replayedDeath = frame;
+        if (firstMismatch < 0 && ((dead != 0) != game.playerDead || liveObjects != game.falling.size()))
+            firstMismatch = frame;
+        ++frame;
+    }
+
+    std::cout << "Replay: " << frame << " frames, sim " << simSeconds * 1000.0 << " ms ("
+              << (frame ? simSeconds * 1e6 / frame : 0.0) << " us/frame)\n";
+    std::cout << "Replay: death frame recorded " << recordedDeath << ", replayed " << replayedDeath << "\n";
+    if (firstMismatch >= 0)
+    {
+        std::cerr << "Replay: diverged at frame " << firstMismatch << "\n";
+        return false;
+    }
+    std::cout << "Replay: matches recording\n";
+    return true;
+}
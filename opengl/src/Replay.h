@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <glm/glm.hpp>
+
+class Game;
+
+// Bits of the header's rules byte
+enum : uint8_t
+{
+    REPLAY_CCD = 1,         // Game::continuousCollision
+    REPLAY_KEEP_LANDED = 2, // Game::keepLanded
+    REPLAY_HULLS = 4,       // Game::hullNarrowphase
+};
+
+// Compact binary recording of a play session for deterministic replays.
+// Layout (native endianness):
+//   header: char[4] "HGLR", uint32 version, uint32 seed, float simHz, int32 maxSubsteps,
+//           uint8 rules   (REPLAY_CCD | REPLAY_KEEP_LANDED | REPLAY_HULLS: the switches that change outcomes)
+//   frame*: float dt, float cameraFront[3], float cameraUp[3],
+//           uint8 keyCount, uint16 keys[keyCount]   (codes of keys held down)
+//           uint8 playerDead, uint32 liveObjects     (outcome after the frame, for verification)
+class ReplayRecorder
+{
+public:
+    // Call right after Game::Reset so the header captures the seed of the new run
+    bool Begin(const std::string &path, const Game &game);
+    // Call after Game::Advance with the same inputs that were passed to it
+    void RecordFrame(float dt, const bool keys[1024], const glm::vec3 &cameraFront,
+                     const glm::vec3 &cameraUp, const Game &game);
+    void End();
+    bool IsRecording() const { return out.is_open(); }
+
+private:
+    std::ofstream out;
+    uint32_t frames = 0;
+};
+
+// Feed a recording back through Game::Advance with no rendering, checking that the
+// player dies on the same frame and the live object count matches every frame.
+// Resources must already be loaded. The recording's rules replace the game's; switches that
+// leave outcomes alone (parallelUpdate, separatingAxisCache, landingTimers) are kept. Prints timing so runs can be compared; returns
+// true when the replay matches the recording.
+bool RunReplay(const std::string &path, Game &game);
@@ -3,19 +3,43 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "UniformBlocks.h"
 
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <cstring>
+#include <unordered_map>
+
+// Interned uniform name, shared by every program. Resolve once (e.g. into a function-local
+// static) and pass to the Shader setters to skip the name lookup entirely.
+struct UniformId
+{
+    int index = -1;
+};
 
 class Shader
 {
 public:
     unsigned int ID;
-    // constructor generates the shader on the fly
+    // glUniform* calls made / skipped because the value matched the last one set on this program
+    mutable unsigned int uniformUploads = 0;
+    mutable unsigned int uniformSkips = 0;
+
+    static UniformId Id(const std::string &name)
+    {
+        static std::unordered_map<std::string, int> ids;
+        auto it = ids.find(name);
+        if (it == ids.end())
+            it = ids.emplace(name, (int)ids.size()).first;
+        return UniformId{it->second};
+    }
+    // constructor generates the shader on the fly; defines (lines of "#define NAME value")
+    // are inserted after each stage's #version line to specialize it
     // ------------------------------------------------------------------------
-    Shader(const char *vertexPath, const char *fragmentPath)
+    Shader(const char *vertexPath, const char *fragmentPath, const std::string &defines = std::string())
     {
         // 1. retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
@@ -45,6 +69,8 @@ public:
         {
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
         }
+        InsertDefines(vertexCode, defines);
+        InsertDefines(fragmentCode, defines);
         const char *vShaderCode = vertexCode.c_str();
         const char *fShaderCode = fragmentCode.c_str();
         // 2. compile shaders
@@ -68,6 +94,8 @@ public:
         // delete the shaders as they're linked into our program now and no longer necessary
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+        BindUniformBlocks(ID);
+        ReflectUniforms();
     }
     // activate the shader
     // ------------------------------------------------------------------------
@@ -75,66 +103,204 @@ public:
     {
         glUseProgram(ID);
     }
-    // utility uniform functions
+    // true if the program has an active uniform with this name (at default block scope)
+    bool has(UniformId id) const { return slotFor(id) >= 0; }
+    bool has(const std::string &name) const { return has(Id(name)); }
+
+    // utility uniform functions; uniforms the program doesn't have are ignored like location -1
     // ------------------------------------------------------------------------
+    void setBool(UniformId id, bool value) const
+    {
+        setInt(id, (int)value);
+    }
     void setBool(const std::string &name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        setBool(Id(name), value);
     }
     // ------------------------------------------------------------------------
+    void setInt(UniformId id, int value) const
+    {
+        if (UniformSlot *s = changed(id, &value, sizeof(value)))
+            glUniform1i(s->location, value);
+    }
     void setInt(const std::string &name, int value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        setInt(Id(name), value);
     }
     // ------------------------------------------------------------------------
+    void setFloat(UniformId id, float value) const
+    {
+        if (UniformSlot *s = changed(id, &value, sizeof(value)))
+            glUniform1f(s->location, value);
+    }
     void setFloat(const std::string &name, float value) const
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        setFloat(Id(name), value);
     }
     // ------------------------------------------------------------------------
+    void setVec2(UniformId id, const glm::vec2 &value) const
+    {
+        if (UniformSlot *s = changed(id, &value[0], sizeof(value)))
+            glUniform2fv(s->location, 1, &value[0]);
+    }
     void setVec2(const std::string &name, const glm::vec2 &value) const
     {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        setVec2(Id(name), value);
     }
     void setVec2(const std::string &name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+        setVec2(Id(name), glm::vec2(x, y));
     }
     // ------------------------------------------------------------------------
+    void setVec3(UniformId id, const glm::vec3 &value) const
+    {
+        if (UniformSlot *s = changed(id, &value[0], sizeof(value)))
+            glUniform3fv(s->location, 1, &value[0]);
+    }
     void setVec3(const std::string &name, const glm::vec3 &value) const
     {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        setVec3(Id(name), value);
     }
     void setVec3(const std::string &name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        setVec3(Id(name), glm::vec3(x, y, z));
     }
     // ------------------------------------------------------------------------
+    void setVec4(UniformId id, const glm::vec4 &value) const
+    {
+        if (UniformSlot *s = changed(id, &value[0], sizeof(value)))
+            glUniform4fv(s->location, 1, &value[0]);
+    }
     void setVec4(const std::string &name, const glm::vec4 &value) const
     {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        setVec4(Id(name), value);
     }
     void setVec4(const std::string &name, float x, float y, float z, float w) const
     {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        setVec4(Id(name), glm::vec4(x, y, z, w));
     }
     // ------------------------------------------------------------------------
+    void setMat2(UniformId id, const glm::mat2 &mat) const
+    {
+        if (UniformSlot *s = changed(id, &mat[0][0], sizeof(mat)))
+            glUniformMatrix2fv(s->location, 1, GL_FALSE, &mat[0][0]);
+    }
     void setMat2(const std::string &name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        setMat2(Id(name), mat);
     }
     // ------------------------------------------------------------------------
+    void setMat3(UniformId id, const glm::mat3 &mat) const
+    {
+        if (UniformSlot *s = changed(id, &mat[0][0], sizeof(mat)))
+            glUniformMatrix3fv(s->location, 1, GL_FALSE, &mat[0][0]);
+    }
     void setMat3(const std::string &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        setMat3(Id(name), mat);
     }
     // ------------------------------------------------------------------------
+    void setMat4(UniformId id, const glm::mat4 &mat) const
+    {
+        if (UniformSlot *s = changed(id, &mat[0][0], sizeof(mat)))
+            glUniformMatrix4fv(s->location, 1, GL_FALSE, &mat[0][0]);
+    }
     void setMat4(const std::string &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        setMat4(Id(name), mat);
     }
 
 private:
+    // One active uniform (array elements get a slot each) with the last value uploaded to it
+    struct UniformSlot
+    {
+        GLint location = -1;
+        bool valid = false;
+        unsigned char value[sizeof(glm::mat4)];
+    };
+    mutable std::vector<UniformSlot> slots;
+    std::vector<int> slotById;         // UniformId index -> slot, -1 = not in this program
+
+    // Put the defines right after "#version ..." (GLSL requires it to come first)
+    static void InsertDefines(std::string &code, const std::string &defines)
+    {
+        if (defines.empty())
+            return;
+        size_t version = code.find("#version");
+        size_t at = version == std::string::npos ? 0 : code.find('\n', version);
+        at = at == std::string::npos ? code.size() : at + 1;
+        code.insert(at, defines);
+    }
+
+    // Enumerate the linked program's uniforms once, so setters never ask the driver by name
+    void ReflectUniforms()
+    {
+        GLint count = 0, maxLen = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+        std::vector<GLchar> buf(maxLen > 0 ? maxLen : 1);
+        for (GLint u = 0; u < count; ++u)
+        {
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)u, (GLsizei)buf.size(), nullptr, &size, &type, buf.data());
+            std::string name(buf.data());
+            // uniform block members have no location; arrays report as "name[0]"
+            if (glGetUniformLocation(ID, name.c_str()) < 0)
+                continue;
+            size_t bracket = name.find('[');
+            if (bracket == std::string::npos)
+            {
+                addSlot(name, glGetUniformLocation(ID, name.c_str()));
+                continue;
+            }
+            std::string base = name.substr(0, bracket);
+            for (GLint e = 0; e < size; ++e)
+            {
+                std::string elem = base + "[" + std::to_string(e) + "]";
+                addSlot(elem, glGetUniformLocation(ID, elem.c_str()));
+            }
+            // the bare name addresses element 0, so it shares that element's slot
+            mapId(Id(base), slotFor(Id(base + "[0]")));
+        }
+    }
+    void addSlot(const std::string &name, GLint location)
+    {
+        UniformSlot s;
+        s.location = location;
+        slots.push_back(s);
+        mapId(Id(name), (int)slots.size() - 1);
+    }
+    void mapId(UniformId id, int slot)
+    {
+        if (id.index >= (int)slotById.size())
+            slotById.resize(id.index + 1, -1);
+        slotById[id.index] = slot;
+    }
+    int slotFor(UniformId id) const
+    {
+        if (id.index < 0 || id.index >= (int)slotById.size())
+            return -1;
+        return slotById[id.index];
+    }
+    // Slot to upload to, or nullptr if the uniform is missing or already holds this value
+    UniformSlot *changed(UniformId id, const void *data, size_t bytes) const
+    {
+        int slot = slotFor(id);
+        if (slot < 0)
+            return nullptr;
+        UniformSlot &s = slots[slot];
+        if (s.valid && std::memcmp(s.value, data, bytes) == 0)
+        {
+            ++uniformSkips;
+            return nullptr;
+        }
+        std::memcpy(s.value, data, bytes);
+        s.valid = true;
+        ++uniformUploads;
+        return &s;
+    }
+
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(GLuint shader, std::string type)
@@ -163,4 +329,4 @@ private:
         }
     }
 };
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
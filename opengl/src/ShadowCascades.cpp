@@ -0,0 +1,84 @@
+// src/ShadowCascades.cpp
+#include "ShadowCascades.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+
+void ProjectionDepthRange(const glm::mat4 &proj, float &nearZ, float &farZ)
+{
+    // glm::perspective (GL clip space): P[2][2] = -(f+n)/(f-n), P[3][2] = -2fn/(f-n)
+    float a = proj[2][2], b = proj[3][2];
+    nearZ = b / (a - 1.0f);
+    farZ = b / (a + 1.0f);
+}
+
+void ComputeCascadeSplits(float nearZ, float farZ, int count, float lambda, float *splitFar)
+{
+    for (int i = 1; i <= count; ++i)
+    {
+        float f = (float)i / (float)count;
+        float logSplit = nearZ * std::pow(farZ / nearZ, f);
+        float uniSplit = nearZ + (farZ - nearZ) * f;
+        splitFar[i - 1] = lambda * logSplit + (1.0f - lambda) * uniSplit;
+    }
+    splitFar[count - 1] = farZ;
+}
+
+void FrustumSliceCorners(const glm::mat4 &view, const glm::mat4 &proj, float sliceNear, float sliceFar,
+                         glm::vec3 corners[8])
+{
+    float nearZ, farZ;
+    ProjectionDepthRange(proj, nearZ, farZ);
+    glm::mat4 inv = glm::inverse(proj * view);
+    // view depth is linear along each edge from the near plane corner to the far one
+    float t0 = (sliceNear - nearZ) / (farZ - nearZ);
+    float t1 = (sliceFar - nearZ) / (farZ - nearZ);
+    int k = 0;
+    for (int y = -1; y <= 1; y += 2)
+    {
+        for (int x = -1; x <= 1; x += 2)
+        {
+            glm::vec4 n = inv * glm::vec4((float)x, (float)y, -1.0f, 1.0f);
+            glm::vec4 f = inv * glm::vec4((float)x, (float)y, 1.0f, 1.0f);
+            glm::vec3 pn = glm::vec3(n) / n.w, pf = glm::vec3(f) / f.w;
+            corners[k] = pn + (pf - pn) * t0;
+            corners[k + 4] = pn + (pf - pn) * t1;
+            ++k;
+        }
+    }
+}
+
+glm::mat4 FitCascade(const glm::vec3 corners[8], const glm::vec3 &lightDir, unsigned int resolution,
+                     float casterDistance, unsigned int snapTexels)
+{
+    glm::vec3 center(0.0f);
+    for (int i = 0; i < 8; ++i)
+        center += corners[i];
+    center /= 8.0f;
+    float radius = 0.0f;
+    for (int i = 0; i < 8; ++i)
+        radius = glm::max(radius, glm::length(corners[i] - center));
+    // round up so float noise in the corners can't change the texel size frame to frame
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+
+    // fixed light frame through the origin; only the ortho box moves
+    glm::vec3 up = std::fabs(lightDir.y) > 0.99f ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
+    glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+    glm::vec3 c = glm::vec3(lightView * glm::vec4(center, 1.0f));
+
+    // half extent: at least radius + one snap step, and exactly resolution / 2 texels
+    float snap = (float)glm::max(snapTexels, 1u);
+    float texel = 2.0f * radius / ((float)resolution - 2.0f * snap);
+    // a round binary fraction, so the box edges come out exact wherever the centre snaps to
+    texel = std::ceil(texel * 65536.0f) / 65536.0f;
+    float step = snap * texel;
+    float half = texel * (float)resolution * 0.5f;
+    c.x = std::floor(c.x / step) * step;
+    c.y = std::floor(c.y / step) * step;
+    if (snapTexels > 1)
+        c.z = std::floor(c.z / step) * step;
+
+    // the light looks down -z: distance in front of it is -z
+    glm::mat4 lightProj = glm::ortho(c.x - half, c.x + half, c.y - half, c.y + half,
+                                     -c.z - half - casterDistance, -c.z + half);
+    return lightProj * lightView;
+}
@@ -0,0 +1,28 @@
+// src/ShadowCascades.h
+#pragma once
+#include <glm/glm.hpp>
+
+// Cascaded shadow map fitting, without GL: the renderer uploads the matrices, HelloGLSim checks them.
+static constexpr int MAX_CASCADES = 4;
+
+// Near/far clip distances of a perspective projection matrix
+void ProjectionDepthRange(const glm::mat4 &proj, float &nearZ, float &farZ);
+
+// View distances where each of count cascades ends, blending logarithmic and uniform splits
+// (lambda = 1: fully logarithmic). splitFar[count - 1] == farZ.
+void ComputeCascadeSplits(float nearZ, float farZ, int count, float lambda, float *splitFar);
+
+// World-space corners of the camera frustum between view distances sliceNear and sliceFar
+// (first four on the near side)
+void FrustumSliceCorners(const glm::mat4 &view, const glm::mat4 &proj, float sliceNear, float sliceFar,
+                         glm::vec3 corners[8]);
+
+// Light view-projection for one cascade. The slice is wrapped in its bounding sphere, so the
+// box keeps its size while the camera turns, and the box centre is snapped to whole shadow
+// map texels in the light's frame, so moving the camera doesn't make shadow edges shimmer.
+// casterDistance extends the box toward the light to catch casters outside the slice.
+// snapTexels > 1 moves the box in steps of that many texels (in depth too) and widens it by
+// one step so the slice stays covered: the matrix then stays identical while the camera
+// moves within a step, which lets a cached shadow layer be reused.
+glm::mat4 FitCascade(const glm::vec3 corners[8], const glm::vec3 &lightDir, unsigned int resolution,
+                     float casterDistance, unsigned int snapTexels = 1);
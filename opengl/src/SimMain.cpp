@@ -0,0 +1,1112 @@
+// HelloGLSim: the game simulation without a window, GL context or audio.
+// Used for profiling and benchmarking Game::Update on headless machines.
+//
+//   HelloGLSim --replay run.bin      replay a recording made with HelloGL --record
+//   HelloGLSim --ticks 36000         soak test: run N fixed ticks with scripted input
+//              --seed 1234           fixed RNG seed for the soak (default: 1)
+//              --serial              step falling objects on the calling thread only
+//              --hz 20               simulation tick rate (default: 60)
+//              --ccd                 swept collision tests (Game::continuousCollision)
+//              --no-props            remove objects on landing instead of keeping them (Game::keepLanded)
+//              --no-axis-cache       always run the full player OBB test (Game::separatingAxisCache)
+//              --no-hull             trust OBB hits without the GJK hull test (Game::hullNarrowphase)
+//              --no-timers           test every object every tick instead of waking them by timer (Game::landingTimers)
+//   HelloGLSim --check-sat 100000    cross-check and time the batched OBB test on random boxes
+//   HelloGLSim --check-hull 100000   cross-check GJK against the OBB test, time hull build/cache/GJK and
+//                                    check the game models' reduced hulls never miss an exact-hull contact
+//   HelloGLSim --bench-broadphase    compare CollisionWorld broadphases at 100, 10k and 100k bodies
+//   HelloGLSim --check-broadphase    ... at 100 and 10k bodies only (the CTest run)
+//   HelloGLSim --check-cull 1000000  cross-check and time the batched frustum test on random spheres
+//   HelloGLSim --check-cascades 600  fit shadow cascades along a camera path and check coverage/stability
+//   HelloGLSim --check-props 1500    drop props into a pile and check they all fall asleep once it settles
+//   HelloGLSim --bench-vertex-formats  pack the game's models in each vertex layout: sizes, encode time, error
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h> // key codes only
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "Game.h"
+#include "Collision.h"
+#include "CollisionWorld.h"
+#include "ConvexHull.h"
+#include "CpuFeatures.h"
+#include "Culling.h"
+#include "FallingSet.h"
+#include "Transform.h"
+#include "Paths.h"
+#include "Props.h"
+#include "Replay.h"
+#include "ShadowCascades.h"
+#include "VertexPacking.h"
+
+// Scripted soak input: walk forward while strafing left/right every two seconds
+static void SoakKeys(long tick, float simHz, bool keys[1024])
+{
+    std::memset(keys, 0, 1024 * sizeof(bool));
+    long phase = (long)(tick / (2.0f * simHz)) % 4;
+    keys[GLFW_KEY_W] = (phase == 0 || phase == 2);
+    keys[GLFW_KEY_A] = (phase == 1);
+    keys[GLFW_KEY_D] = (phase == 3);
+}
+
+static int RunSoak(Game &game, long ticks)
+{
+    bool keys[1024];
+    const glm::vec3 front(0.0f, 0.0f, -1.0f);
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+    const float step = 1.0f / game.simHz;
+
+    game.Reset();
+    long deaths = 0;
+    size_t peakLive = 0, peakProps = 0, peakAwake = 0;
+    uint64_t narrowTests = 0, axisCacheHits = 0, hullTests = 0, hullRejects = 0;
+    uint64_t objectTicks = 0, collisionObjects = 0, timersFired = 0;
+    uint64_t steadyAllocs = 0;
+    double totalSec = 0.0, worstSec = 0.0;
+
+    for (long t = 0; t < ticks; ++t)
+    {
+        if (game.playerDead)
+        {
+            ++deaths;
+            game.Reset();
+        }
+        SoakKeys(t, game.simHz, keys);
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        game.Update(step, keys, front, up);
+        double sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+
+        totalSec += sec;
+        worstSec = std::max(worstSec, sec);
+        peakLive = std::max(peakLive, game.falling.size());
+        peakProps = std::max(peakProps, game.props.size());
+        peakAwake = std::max(peakAwake, game.props.AwakeCount());
+        narrowTests += game.narrowTestsLastTick;
+        axisCacheHits += game.axisCacheHitsLastTick;
+        hullTests += game.hullTestsLastTick;
+        hullRejects += game.hullRejectsLastTick;
+        objectTicks += game.fallingSteppedLastTick;
+        collisionObjects += game.collisionObjectsLastTick;
+        timersFired += game.timersFiredLastTick;
+        if (t > 0)
+            steadyAllocs += game.allocationsLastTick;
+    }
+
+    std::cout << "Soak: " << ticks << " ticks, seed " << game.seed << ", kernel " << FallingKernelName()
+              << (game.parallelUpdate ? ", parallel" : ", serial")
+              << ", " << game.simHz << " Hz" << (game.continuousCollision ? ", swept collision" : "") << "\n"
+              << "  sim time " << totalSec * 1000.0 << " ms, avg " << totalSec * 1e6 / std::max(ticks, 1L)
+              << " us/tick, worst " << worstSec * 1e6 << " us\n"
+              << "  deaths " << deaths << ", peak live objects " << peakLive
+              << ", peak props " << peakProps << " (" << peakAwake << " awake)"
+              << ", heap allocations after first tick " << steadyAllocs << "\n"
+              << "  player narrowphase tests " << narrowTests << ", separating axis cache hits "
+              << 100.0 * axisCacheHits / std::max<uint64_t>(narrowTests, 1) << "%"
+              << (game.separatingAxisCache ? "" : " (cache off)") << "\n"
+              << "  hull tests " << hullTests << ", OBB hits overruled by the hulls " << hullRejects
+              << (game.hullNarrowphase ? "" : " (hull test off)") << "\n"
+              << "  objects needing collision work " << 100.0 * collisionObjects / std::max<uint64_t>(objectTicks, 1)
+              << "% of object-ticks, landing timers fired " << timersFired
+              << (game.landingTimers ? "" : " (timers off)") << "\n";
+    return 0;
+}
+
+// Drops props at random spots, one per tick, then lets the piles settle. Once spawning stops
+// nothing pushes the props any more, so the awake set must drain to nothing and stay there:
+// a prop that keeps buzzing against its neighbours costs solver work every tick.
+static int RunPropCheck(long count)
+{
+    const float dt = 1.0f / 60.0f, gravity = -9.8f * 0.2f, floorTop = -0.5f; // as Game
+    const long spawnEvery = 1, settleTicks = 3000, steadyTicks = 600;
+
+    PropSet props(count);
+    std::mt19937 rng(4242);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f), spot(-4.0f, 4.0f), half(0.15f, 0.5f);
+    LocalBox box;
+    long spawned = 0, tick = 0;
+    size_t peakAwake = 0, steadyAwake = 0;
+    long settledAt = -1;
+    double stepSec = 0.0;
+    for (; tick < count * spawnEvery + settleTicks; ++tick)
+    {
+        if (spawned < count && tick % spawnEvery == 0)
+        {
+            glm::quat q = glm::normalize(glm::quat(u(rng), u(rng), u(rng), u(rng)) + glm::quat(1e-3f, 0.0f, 0.0f, 0.0f));
+            box.half = glm::vec3(half(rng), half(rng), half(rng));
+            props.Add(glm::vec3(spot(rng), 4.0f, spot(rng)), q, glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f),
+                      glm::vec3(1.0f), 0, box);
+            ++spawned;
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
+        props.Step(dt, gravity, floorTop);
+        stepSec += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+
+        size_t awake = props.AwakeCount();
+        peakAwake = std::max(peakAwake, awake);
+        if (spawned == count && awake == 0 && settledAt < 0)
+            settledAt = tick - count * spawnEvery;
+        if (tick >= count * spawnEvery + settleTicks - steadyTicks)
+            steadyAwake = std::max(steadyAwake, awake);
+    }
+    bool ok = steadyAwake == 0;
+    std::cout << "Prop check: " << count << " props, peak awake " << peakAwake << ", all asleep "
+              << (settledAt >= 0 ? std::to_string(settledAt) + " ticks after the last spawn" : std::string("never"))
+              << ", awake over the last " << steadyTicks << " ticks at most " << steadyAwake << ", step " << stepSec * 1e6 / tick << " us/tick\n";
+    return ok ? 0 : 1;
+}
+
+// Random box near the origin: arbitrary orientation, half extents 0.05..1
+static OBB RandomOBB(std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> h(0.05f, 1.0f);
+    glm::quat q = glm::normalize(glm::quat(u(rng), u(rng), u(rng), u(rng)) + glm::quat(1e-3f, 0.0f, 0.0f, 0.0f));
+    glm::mat3 r = QuatToMat3(q);
+    OBB box;
+    box.center = glm::vec3(u(rng), u(rng), u(rng)) * 2.0f;
+    for (int k = 0; k < 3; ++k)
+    {
+        box.axis[k] = r[k];
+        box.half[k] = h(rng);
+    }
+    return box;
+}
+
+// Temporal coherence, laid out like the player test in Game: one box against many boxes
+// drifting a little every frame, tested from scratch (batched) and with each box's
+// separating axis from the previous frame tried first (misses batched as they come).
+// Returns the number of boxes where the two paths disagree (must be 0).
+template <typename LaneBox>
+static long RunAxisCacheBench(const std::vector<OBB> &as, const std::vector<OBBBatch> &bs, LaneBox laneBox)
+{
+    const int frames = 30;
+    const long count = std::min<long>((long)bs.size(), 4096) * OBBBatch::SIZE;
+    const OBB &A = as[0];
+
+    std::mt19937 rng(999);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    std::vector<OBB> boxes(count);
+    std::vector<glm::vec3> drift(count);
+    std::vector<glm::mat3> spin(count);
+    for (long p = 0; p < count; ++p)
+    {
+        boxes[p] = laneBox(bs[p / OBBBatch::SIZE], (int)(p % OBBBatch::SIZE));
+        drift[p] = glm::vec3(u(rng), u(rng), u(rng)) * 0.01f;
+        glm::vec3 axis = glm::normalize(glm::vec3(u(rng), u(rng), u(rng)) + glm::vec3(1e-3f));
+        spin[p] = QuatToMat3(glm::angleAxis(0.02f * u(rng), axis));
+    }
+    std::vector<int8_t> cached(count, -1);
+    std::vector<uint8_t> fullHit(count), cachedHit(count);
+
+    using Clock = std::chrono::high_resolution_clock;
+    double fullSec = 0.0, cachedSec = 0.0;
+    long hits = 0, tests = 0, mismatch = 0;
+    for (int f = 0; f < frames; ++f)
+    {
+        for (long p = 0; p < count; ++p)
+        {
+            boxes[p].center += drift[p];
+            for (int k = 0; k < 3; ++k)
+                boxes[p].axis[k] = spin[p] * boxes[p].axis[k];
+        }
+
+        auto t0 = Clock::now();
+        for (long n = 0; n < count; n += OBBBatch::SIZE)
+        {
+            OBBBatch batch;
+            for (int lane = 0; lane < OBBBatch::SIZE; ++lane)
+                batch.Add(boxes[n + lane]);
+            uint32_t m = OBBOverlapBatch(A, batch);
+            for (int lane = 0; lane < OBBBatch::SIZE; ++lane)
+                fullHit[n + lane] = (m >> lane) & 1u;
+        }
+        auto t1 = Clock::now();
+        OBBBatch batch;
+        long pending[OBBBatch::SIZE];
+        int8_t axes[OBBBatch::SIZE];
+        auto flush = [&]()
+        {
+            uint32_t m = OBBOverlapBatch(A, batch, axes);
+            for (int lane = 0; lane < batch.count; ++lane)
+            {
+                cached[pending[lane]] = axes[lane];
+                cachedHit[pending[lane]] = (m >> lane) & 1u;
+            }
+            batch.Clear();
+        };
+        for (long p = 0; p < count; ++p)
+        {
+            int8_t axis = cached[p];
+            if (axis >= 0 && OBBSeparatedOnAxis(A, boxes[p], axis))
+            {
+                cachedHit[p] = 0;
+                ++hits;
+                continue;
+            }
+            pending[batch.Add(boxes[p])] = p;
+            if (batch.Full())
+                flush();
+        }
+        flush();
+        auto t2 = Clock::now();
+
+        tests += count;
+        if (f > 0) // the first frame fills the cache
+        {
+            fullSec += std::chrono::duration<double>(t1 - t0).count();
+            cachedSec += std::chrono::duration<double>(t2 - t1).count();
+        }
+        for (long p = 0; p < count; ++p)
+            mismatch += fullHit[p] != cachedHit[p];
+    }
+
+    const double timed = (double)count * (frames - 1);
+    std::cout << "  coherent motion (" << count << " boxes x " << frames << " frames): axis cache hit rate "
+              << 100.0 * hits / std::max(tests, 1L) << "%, ns/box full " << fullSec * 1e9 / timed
+              << ", cached " << cachedSec * 1e9 / timed << ", mismatches " << mismatch << "\n";
+    return mismatch;
+}
+
+// Batched SAT must match the scalar Gottschalk test lane for lane, and the original
+// normalized-axis OBBIntersectSAT except for boxes that are within rounding of touching.
+static int RunSatCheck(long boxes)
+{
+    std::mt19937 rng(12345);
+    const long batches = std::max(boxes / OBBBatch::SIZE, 1L);
+    std::vector<OBB> as(batches);
+    std::vector<OBBBatch> bs(batches);
+    for (long n = 0; n < batches; ++n)
+    {
+        as[n] = RandomOBB(rng);
+        for (int lane = 0; lane < OBBBatch::SIZE; ++lane)
+        {
+            OBB b = RandomOBB(rng);
+            // every 16th batch has a box sharing A's axes, to exercise the parallel-edge epsilon
+            if (lane == 0 && n % 16 == 0)
+                for (int k = 0; k < 3; ++k)
+                    b.axis[k] = as[n].axis[k];
+            bs[n].Add(b);
+        }
+    }
+
+    auto laneBox = [](const OBBBatch &batch, int lane)
+    {
+        OBB b;
+        b.center = glm::vec3(batch.cx[lane], batch.cy[lane], batch.cz[lane]);
+        for (int k = 0; k < 3; ++k)
+        {
+            b.axis[k] = glm::vec3(batch.ax[k][lane], batch.ay[k][lane], batch.az[k][lane]);
+            b.half[k] = batch.half[k][lane];
+        }
+        return b;
+    };
+
+    long overlaps = 0, batchMismatch = 0, legacyMismatch = 0, boundary = 0;
+    for (long n = 0; n < batches; ++n)
+    {
+        uint32_t mask = OBBOverlapBatch(as[n], bs[n]);
+        for (int lane = 0; lane < OBBBatch::SIZE; ++lane)
+        {
+            OBB b = laneBox(bs[n], lane);
+            bool batched = (mask >> lane) & 1u;
+            overlaps += batched;
+            if (batched != OBBOverlap(as[n], b))
+                ++batchMismatch;
+            if (batched != OBBIntersectSAT(as[n], b))
+            {
+                OBB shrunk = b, grown = b;
+                for (int k = 0; k < 3; ++k)
+                {
+                    shrunk.half[k] *= 0.999f;
+                    grown.half[k] *= 1.001f;
+                }
+                if (OBBIntersectSAT(as[n], shrunk) != OBBIntersectSAT(as[n], grown))
+                    ++boundary;
+                else
+                    ++legacyMismatch;
+            }
+        }
+    }
+
+    // timing: the same pairs through each implementation
+    using Clock = std::chrono::high_resolution_clock;
+    volatile long sink = 0;
+    auto t0 = Clock::now();
+    for (long n = 0; n < batches; ++n)
+        for (int lane = 0; lane < OBBBatch::SIZE; ++lane)
+            sink += OBBIntersectSAT(as[n], laneBox(bs[n], lane));
+    auto t1 = Clock::now();
+    for (long n = 0; n < batches; ++n)
+        for (int lane = 0; lane < OBBBatch::SIZE; ++lane)
+            sink += OBBOverlap(as[n], laneBox(bs[n], lane));
+    auto t2 = Clock::now();
+    for (long n = 0; n < batches; ++n)
+        sink += (long)OBBOverlapBatch(as[n], bs[n]);
+    auto t3 = Clock::now();
+
+    const double pairs = (double)batches * OBBBatch::SIZE;
+    auto nsPerPair = [&](Clock::time_point a, Clock::time_point b)
+    { return std::chrono::duration<double, std::nano>(b - a).count() / pairs; };
+    const CpuFeatures &cpu = GetCpuFeatures();
+    std::cout << "SAT check: " << (long)pairs << " pairs, " << overlaps << " overlapping, batch kernel "
+              << (cpu.avx ? "avx" : cpu.sse2 ? "sse2" : "scalar") << "\n"
+              << "  batched vs scalar Gottschalk mismatches: " << batchMismatch << "\n"
+              << "  batched vs OBBIntersectSAT mismatches: " << legacyMismatch
+              << " (plus " << boundary << " touching within rounding)\n"
+              << "  ns/pair: OBBIntersectSAT " << nsPerPair(t0, t1) << ", OBBOverlap " << nsPerPair(t1, t2)
+              << ", OBBOverlapBatch " << nsPerPair(t2, t3) << "\n";
+    long axisMismatch = 0;
+    for (long n = 0; n < batches; ++n)
+    {
+        int8_t axes[OBBBatch::SIZE];
+        OBBOverlapBatch(as[n], bs[n], axes);
+        for (int lane = 0; lane < OBBBatch::SIZE; ++lane)
+            if (axes[lane] != OBBSeparatingAxis(as[n], laneBox(bs[n], lane)))
+                ++axisMismatch;
+    }
+    std::cout << "  batched vs scalar separating axis mismatches: " << axisMismatch << "\n";
+
+    long coherenceMismatch = RunAxisCacheBench(as, bs, laneBox);
+    return (batchMismatch == 0 && legacyMismatch == 0 && axisMismatch == 0 && coherenceMismatch == 0) ? 0 : 1;
+}
+
+// Placement of a hull built from the corners of a unit box so that it matches box exactly
+static HullPose BoxHullPose(const ConvexHull &unitBox, const OBB &box)
+{
+    HullPose pose;
+    pose.hull = &unitBox;
+    pose.rot = glm::mat3(box.axis[0], box.axis[1], box.axis[2]);
+    pose.pos = box.center;
+    pose.scale = glm::vec3(box.half[0], box.half[1], box.half[2]) * 2.0f;
+    return pose;
+}
+
+// GJK on box-shaped hulls must agree with the OBB test except for boxes within rounding of
+// touching; quickhull must find exactly the corners of a box filled with points. Then times
+// hull build, cache load and GJK on a rounded 16k-vertex cloud, and counts how many OBB hits
+// between two such shapes the hulls overrule.
+static int RunHullCheck(long pairs)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    auto ms = [](Clock::time_point a, Clock::time_point b)
+    { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> u(-0.5f, 0.5f);
+
+    // box corners plus interior points: the hull is the 8 corners
+    std::vector<glm::vec3> boxPoints;
+    for (int c = 0; c < 8; ++c)
+        boxPoints.push_back(glm::vec3((c & 1) ? 0.5f : -0.5f, (c & 2) ? 0.5f : -0.5f, (c & 4) ? 0.5f : -0.5f));
+    for (int n = 0; n < 1000; ++n)
+        boxPoints.push_back(glm::vec3(u(rng), u(rng), u(rng)) * 0.99f);
+    int boxHullVertices = 0;
+    ConvexHull unitBox = BuildConvexHull(boxPoints, HULL_MAX_VERTICES, &boxHullVertices);
+    bool boxOk = boxHullVertices == 8 && unitBox.points.size() == 8;
+
+    long overlaps = 0, mismatch = 0, boundary = 0, totalIterations = 0;
+    int maxIterations = 0;
+    std::vector<OBB> as(pairs), bs(pairs);
+    for (long n = 0; n < pairs; ++n)
+    {
+        as[n] = RandomOBB(rng);
+        bs[n] = RandomOBB(rng);
+    }
+    for (long n = 0; n < pairs; ++n)
+    {
+        int iterations = 0;
+        bool gjk = GJKOverlap(BoxHullPose(unitBox, as[n]), BoxHullPose(unitBox, bs[n]), &iterations);
+        bool sat = OBBOverlap(as[n], bs[n]);
+        overlaps += sat;
+        totalIterations += iterations;
+        maxIterations = std::max(maxIterations, iterations);
+        if (gjk == sat)
+            continue;
+        OBB shrunk = bs[n], grown = bs[n];
+        for (int k = 0; k < 3; ++k)
+        {
+            shrunk.half[k] *= 0.999f;
+            grown.half[k] *= 1.001f;
+        }
+        if (OBBOverlap(as[n], shrunk) != OBBOverlap(as[n], grown))
+            ++boundary;
+        else
+            ++mismatch;
+    }
+
+    volatile long sink = 0;
+    auto t0 = Clock::now();
+    for (long n = 0; n < pairs; ++n)
+        sink += OBBOverlap(as[n], bs[n]);
+    auto t1 = Clock::now();
+    for (long n = 0; n < pairs; ++n)
+        sink += GJKOverlap(BoxHullPose(unitBox, as[n]), BoxHullPose(unitBox, bs[n]));
+    auto t2 = Clock::now();
+
+    std::cout << "Hull check: " << pairs << " box pairs, " << overlaps << " overlapping\n"
+              << "  box hull: " << boxHullVertices << " hull vertices of " << boxPoints.size()
+              << (boxOk ? " (ok)" : " (expected the 8 corners)") << "\n"
+              << "  GJK vs OBBOverlap mismatches: " << mismatch << " (plus " << boundary
+              << " touching within rounding)\n"
+              << "  GJK iterations: avg " << (double)totalIterations / std::max(pairs, 1L) << ", max "
+              << maxIterations << " (cap " << GJK_MAX_ITERATIONS << ")\n"
+              << "  ns/pair: OBBOverlap " << ms(t0, t1) * 1e6 / pairs << ", GJK 8-vertex hulls "
+              << ms(t1, t2) * 1e6 / pairs << "\n";
+
+    // a rounded, lumpy 16k-vertex cloud (a scanned rock, say) squashed into a box-unfriendly shape
+    std::vector<glm::vec3> cloud;
+    std::normal_distribution<float> g(0.0f, 1.0f);
+    for (int n = 0; n < 16384; ++n)
+    {
+        glm::vec3 d = glm::normalize(glm::vec3(g(rng), g(rng), g(rng)) + glm::vec3(1e-6f));
+        float r = 0.5f * (1.0f + 0.05f * std::sin(7.0f * d.x) * std::cos(5.0f * d.y));
+        cloud.push_back(d * r * glm::vec3(1.0f, 0.6f, 0.8f));
+    }
+    int exactVertices = 0;
+    auto t3 = Clock::now();
+    ConvexHull rock = BuildConvexHull(cloud, HULL_MAX_VERTICES, &exactVertices);
+    auto t4 = Clock::now();
+    std::string cachePath = GetExecutableDir() + "/hull_check.hull";
+    uint64_t hash = HullSourceHash(cloud, HULL_MAX_VERTICES);
+    bool saved = SaveHullCache(cachePath, hash, rock);
+    ConvexHull cached;
+    auto t5 = Clock::now();
+    bool loaded = LoadHullCache(cachePath, HullSourceHash(cloud, HULL_MAX_VERTICES), cached);
+    auto t6 = Clock::now();
+    std::remove(cachePath.c_str());
+    bool cacheOk = saved && loaded && cached.points == rock.points;
+
+    glm::vec3 lo = cloud[0], hi = cloud[0];
+    for (const glm::vec3 &p : cloud)
+    {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    LocalBox rockBox = MakeLocalBox(lo, hi);
+    long obbHits = 0, hullRejects = 0;
+    double gjkSec = 0.0;
+    for (long n = 0; n < pairs; ++n)
+    {
+        HullPose a, b;
+        a.hull = b.hull = &rock;
+        a.rot = glm::mat3(as[n].axis[0], as[n].axis[1], as[n].axis[2]);
+        b.rot = glm::mat3(bs[n].axis[0], bs[n].axis[1], bs[n].axis[2]);
+        a.pos = as[n].center * 0.5f;
+        b.pos = bs[n].center * 0.5f;
+        if (!OBBOverlap(WorldOBB(rockBox, a.pos, a.rot, a.scale), WorldOBB(rockBox, b.pos, b.rot, b.scale)))
+            continue;
+        ++obbHits;
+        auto g0 = Clock::now();
+        bool hit = GJKOverlap(a, b);
+        gjkSec += std::chrono::duration<double>(Clock::now() - g0).count();
+        hullRejects += !hit;
+    }
+    std::cout << "  16k-vertex cloud: " << exactVertices << " hull vertices -> " << rock.points.size()
+              << " kept, built in " << ms(t3, t4) << " ms, cache load " << ms(t5, t6) << " ms"
+              << (cacheOk ? "" : " (cache round trip FAILED)") << "\n"
+              << "  OBB hits between two clouds " << obbHits << ", overruled by GJK " << hullRejects << " ("
+              << 100.0 * hullRejects / std::max(obbHits, 1L) << "%), GJK "
+              << gjkSec * 1e9 / std::max(obbHits, 1L) << " ns/pair with " << rock.points.size() << "-vertex hulls\n";
+    return (boxOk && mismatch == 0 && cacheOk) ? 0 : 1;
+}
+
+// The reduced hulls the game collides with must contain the exact ones: at random poses
+// around contact distance, every player/falling-model pair the exact hulls find touching
+// the reduced hulls must find touching too (pairs within rounding of touching aside).
+// Also reports how many extra hits the grown hulls accept.
+static int RunModelHullCheck(const Game &game, long pairs)
+{
+    auto modelPoints = [](const ModelData &model)
+    {
+        std::vector<glm::vec3> pts;
+        for (const MeshData &mesh : model.meshes)
+            for (const SimpleVertex &v : mesh.vertices)
+                pts.push_back(v.pos);
+        return pts;
+    };
+    auto randomRot = [](std::mt19937 &rng)
+    {
+        std::normal_distribution<float> g(0.0f, 1.0f);
+        glm::quat q(g(rng), g(rng), g(rng), g(rng));
+        return glm::mat3_cast(glm::normalize(q));
+    };
+
+    const ModelData &player = game.playerModel;
+    ConvexHull playerExact = BuildConvexHull(modelPoints(player), INT_MAX);
+    if (player.collision.hull.empty() || playerExact.empty())
+    {
+        std::cout << "Model hull check: player model has no hull (loaded without geometry?)\n";
+        return 1;
+    }
+    float playerScale = std::max(player.modelScale.x, std::max(player.modelScale.y, player.modelScale.z));
+
+    std::mt19937 rng(2468);
+    long totalMissed = 0;
+    std::cout << "Model hull check: player (" << playerExact.points.size() << " -> "
+              << player.collision.hull.points.size() << " vertices) against each falling model, " << pairs
+              << " poses\n";
+    for (int i = 0; i < 3; ++i)
+    {
+        const ModelData &model = game.fallingModels[i];
+        if (model.collision.hull.empty())
+            continue;
+        ConvexHull exact = BuildConvexHull(modelPoints(model), INT_MAX);
+        float scale = std::max(model.modelScale.x, std::max(model.modelScale.y, model.modelScale.z));
+        float reach = player.collision.sphere.radius * playerScale + model.collision.sphere.radius * scale;
+        std::uniform_real_distribution<float> offset(-reach, reach);
+
+        long exactHits = 0, missed = 0, touching = 0, extra = 0;
+        for (long n = 0; n < pairs; ++n)
+        {
+            HullPose pe, pr, oe, orr;
+            pe.hull = &playerExact;
+            pr.hull = &player.collision.hull;
+            pe.rot = pr.rot = randomRot(rng);
+            pe.scale = pr.scale = player.modelScale;
+            glm::vec3 playerCenter = pe.rot * (player.collision.sphere.center * player.modelScale);
+
+            oe.hull = &exact;
+            orr.hull = &model.collision.hull;
+            oe.rot = orr.rot = randomRot(rng);
+            oe.scale = orr.scale = model.modelScale;
+            glm::vec3 objCenter = oe.rot * (model.collision.sphere.center * model.modelScale);
+            oe.pos = orr.pos = playerCenter - objCenter + glm::vec3(offset(rng), offset(rng), offset(rng));
+
+            bool hitExact = GJKOverlap(pe, oe);
+            bool hitReduced = GJKOverlap(pr, orr);
+            exactHits += hitExact;
+            extra += hitReduced && !hitExact;
+            if (hitExact && !hitReduced)
+            {
+                // still touching with the exact object hull slightly shrunk: a real miss
+                HullPose shrunk = oe;
+                shrunk.scale *= 0.998f;
+                shrunk.pos += objCenter * 0.002f;
+                if (GJKOverlap(pe, shrunk))
+                    ++missed;
+                else
+                    ++touching;
+            }
+        }
+        totalMissed += missed;
+        std::cout << "  falling model " << i << " (" << exact.points.size() << " -> "
+                  << model.collision.hull.points.size() << " vertices): exact hulls touch " << exactHits
+                  << ", reduced hulls miss " << missed << " (plus " << touching << " touching within rounding), accept "
+                  << extra << " extra (" << 100.0 * extra / std::max(exactHits, 1L) << "%)\n";
+    }
+    return totalMissed == 0 ? 0 : 1;
+}
+
+// Random boxes at constant density (about one per 8 cubic units) drifting inside a cube,
+// run through each broadphase with the same motion, overlap queries and rays. A few bodies
+// are removed and re-added every frame. Every broadphase must return exactly the pairs,
+// overlaps and ray hits of the first one.
+static bool BenchBroadphaseSize(long bodies)
+{
+    const int frames = 5;
+    const int queries = 1000;
+    const float side = std::cbrt(8.0f * (float)bodies);
+    const float dt = 1.0f / 60.0f;
+
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f), u(-1.0f, 1.0f), h(0.1f, 0.6f);
+    auto randomBox = [&](const glm::vec3 &center)
+    {
+        OBB b = RandomOBB(rng);
+        b.center = center;
+        for (int k = 0; k < 3; ++k)
+            b.half[k] = h(rng);
+        return b;
+    };
+    auto randomPoint = [&]() { return glm::vec3(u01(rng), u01(rng), u01(rng)) * side; };
+
+    std::vector<OBB> start(bodies);
+    std::vector<glm::vec3> vel(bodies);
+    for (long i = 0; i < bodies; ++i)
+    {
+        start[i] = randomBox(randomPoint());
+        vel[i] = glm::vec3(u(rng), u(rng), u(rng)) * 3.0f;
+    }
+    std::vector<OBB> queryBoxes(queries);
+    std::vector<glm::vec3> rayOrigin(queries), rayDir(queries);
+    for (int q = 0; q < queries; ++q)
+    {
+        queryBoxes[q] = randomBox(randomPoint());
+        rayOrigin[q] = randomPoint();
+        rayDir[q] = glm::normalize(glm::vec3(u(rng), u(rng), u(rng)) + glm::vec3(1e-3f));
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto ms = [](Clock::time_point a, Clock::time_point b)
+    { return std::chrono::duration<double, std::milli>(b - a).count(); };
+
+    std::cout << bodies << " bodies (cube side " << side << "):\n";
+    bool haveReference = false, agree = true;
+    std::vector<ProxyPair> refPairs;
+    std::vector<BodyId> refHits;
+    std::vector<RayHit> refRays;
+    std::vector<uint8_t> refRayHit;
+
+    const BroadphaseType types[] = {BroadphaseType::BruteForce, BroadphaseType::SweepAndPrune,
+                                    BroadphaseType::UniformGrid, BroadphaseType::AABBTree};
+    for (BroadphaseType type : types)
+    {
+        std::cout << "  " << BroadphaseName(type) << ": ";
+        if (type == BroadphaseType::BruteForce && bodies > 20000)
+        {
+            std::cout << "skipped (quadratic)\n";
+            continue;
+        }
+
+        std::vector<OBB> boxes = start;
+        std::vector<glm::vec3> v = vel;
+        std::vector<ProxyPair> pairs;
+        std::vector<BodyId> hits;
+
+        auto t0 = Clock::now();
+        CollisionWorld world(type, 1.5f);
+        for (const OBB &b : boxes)
+            world.Add(b);
+        auto t1 = Clock::now();
+        for (int f = 0; f < frames; ++f)
+        {
+            for (long i = 0; i < bodies; ++i)
+            {
+                glm::vec3 &c = boxes[i].center;
+                c += v[i] * dt;
+                for (int k = 0; k < 3; ++k)
+                    if (c[k] < 0.0f || c[k] > side)
+                        v[i][k] = -v[i][k];
+                if (i % 50 == f)
+                {
+                    // the freed id is handed straight back, so body i keeps its id
+                    world.Remove((BodyId)i);
+                    world.Add(boxes[i]);
+                }
+                else
+                    world.Move((BodyId)i, boxes[i]);
+            }
+            world.FindOverlappingPairs(pairs);
+        }
+        auto t2 = Clock::now();
+        for (const OBB &q : queryBoxes)
+            world.QueryOverlap(q, hits);
+        auto t3 = Clock::now();
+        std::vector<RayHit> rays(queries);
+        std::vector<uint8_t> rayHit(queries);
+        for (int q = 0; q < queries; ++q)
+            rayHit[q] = world.RayCast(rayOrigin[q], rayDir[q], side * 0.25f, rays[q]);
+        auto t4 = Clock::now();
+
+        std::cout << "build " << ms(t0, t1) << " ms, move+pairs " << ms(t1, t2) / frames << " ms/frame ("
+                  << pairs.size() << " pairs), " << queries << " overlap queries " << ms(t2, t3) << " ms, "
+                  << queries << " rays " << ms(t3, t4) << " ms\n";
+
+        if (!haveReference)
+        {
+            refPairs = pairs;
+            refHits = hits;
+            refRays = rays;
+            refRayHit = rayHit;
+            haveReference = true;
+            continue;
+        }
+        // pairs and overlaps come back sorted, so the same results mean the same vectors
+        long rayMismatch = 0;
+        for (int q = 0; q < queries; ++q)
+        {
+            if (rayHit[q] != refRayHit[q] ||
+                (rayHit[q] && (rays[q].body != refRays[q].body || std::fabs(rays[q].t - refRays[q].t) > 1e-5f)))
+                ++rayMismatch;
+        }
+        if (pairs != refPairs || hits != refHits || rayMismatch)
+        {
+            std::cout << "    results differ from the first broadphase: pairs " << (pairs == refPairs ? "same" : "differ")
+                      << ", overlaps " << (hits == refHits ? "same" : "differ") << ", rays differing "
+                      << rayMismatch << "\n";
+            agree = false;
+        }
+    }
+    return agree;
+}
+
+// The benchmark adds a 100k-body run; the check stops at 10k so it is quick enough for CTest
+static int RunBroadphaseBench(bool full)
+{
+    bool ok = true;
+    for (long n : {100L, 10000L, 100000L})
+    {
+        if (n > 10000 && !full)
+            break;
+        ok = BenchBroadphaseSize(n) && ok;
+    }
+    return ok ? 0 : 1;
+}
+
+// Batched sphere culling must agree with SphereInFrustum for the same spheres, against a
+// perspective camera and an orthographic light volume like the renderer's; then times both.
+static int RunCullCheck(long spheres)
+{
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<float> coord(-60.0f, 60.0f), rad(0.05f, 3.0f);
+    std::vector<float> x(spheres), y(spheres), z(spheres), r(spheres);
+    for (long i = 0; i < spheres; ++i)
+    {
+        x[i] = coord(rng);
+        y[i] = coord(rng);
+        z[i] = coord(rng);
+        r[i] = rad(rng);
+    }
+    glm::mat4 camera = glm::perspective(glm::radians(45.0f), 1280.0f / 920.0f, 0.1f, 100.0f) *
+                       glm::lookAt(glm::vec3(0.0f, 4.0f, 14.0f), glm::vec3(0.0f, 0.6f, 0.0f), glm::vec3(0, 1, 0));
+    glm::vec3 sunDir = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.2f));
+    glm::mat4 light = glm::ortho(-15.0f, 15.0f, -15.0f, 15.0f, 1.0f, 50.0f) *
+                      glm::lookAt(-sunDir * 20.0f, glm::vec3(0.0f), glm::vec3(0, 1, 0));
+
+    using Clock = std::chrono::high_resolution_clock;
+    std::vector<uint8_t> visible(spheres);
+    long mismatch = 0;
+    std::cout << "Cull check: " << spheres << " spheres, kernel " << CullKernelName() << "\n";
+    const char *names[2] = {"camera", "light"};
+    const glm::mat4 *volumes[2] = {&camera, &light};
+    for (int v = 0; v < 2; ++v)
+    {
+        Frustum f = FrustumFromMatrix(*volumes[v]);
+        auto t0 = Clock::now();
+        size_t batched = CullSpheres(f, x.data(), y.data(), z.data(), r.data(), spheres, visible.data());
+        auto t1 = Clock::now();
+        long scalar = 0;
+        for (long i = 0; i < spheres; ++i)
+        {
+            bool in = SphereInFrustum(f, glm::vec3(x[i], y[i], z[i]), r[i]);
+            scalar += in;
+            mismatch += in != (visible[i] != 0);
+        }
+        auto t2 = Clock::now();
+        auto ns = [&](Clock::time_point a, Clock::time_point b)
+        { return std::chrono::duration<double, std::nano>(b - a).count() / spheres; };
+        std::cout << "  " << names[v] << ": " << batched << " visible (scalar " << scalar << "), ns/sphere batched "
+                  << ns(t0, t1) << ", scalar " << ns(t1, t2) << "\n";
+    }
+    std::cout << "  batched vs scalar mismatches: " << mismatch << "\n";
+    return mismatch == 0 ? 0 : 1;
+}
+
+// Walks and turns a camera like the game's for a number of frames and fits 3 cascades each
+// frame, as GameRenderer does. Every slice corner must land inside its cascade's box, and
+// while a cascade's size holds, a fixed world point must stay at the same sub-texel position
+// (the box only moves by whole texels, so shadow edges don't crawl). The same cascades fitted
+// with the static-cache snap must cover their slices too; reports how often each changes
+// matrix, i.e. how often its cached static shadow layer would be rebuilt.
+static int RunCascadeCheck(long frames)
+{
+    const int count = 3;
+    const unsigned int sizes[count] = {2048, 2048, 1024};
+    glm::mat4 proj = glm::perspective(glm::radians(45.0f), 1280.0f / 920.0f, 0.1f, 100.0f);
+    glm::vec3 sunDir = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.2f));
+    float nearZ, farZ;
+    ProjectionDepthRange(proj, nearZ, farZ);
+    farZ = std::min(farZ, 60.0f);
+    float splitFar[MAX_CASCADES];
+    ComputeCascadeSplits(nearZ, farZ, count, 0.75f, splitFar);
+
+    const glm::vec3 probe(1.3f, 0.0f, -2.7f);
+    glm::vec2 lastFrac[count];
+    float lastScale[count] = {0.0f, 0.0f, 0.0f};
+    const unsigned int cacheSnap = 64;
+    glm::mat4 lastCached[count];
+    long cachedRebuilds[count] = {0, 0, 0};
+    long outside = 0, resized = 0;
+    float maxDrift = 0.0f;
+    for (long f = 0; f < frames; ++f)
+    {
+        float t = (float)f / 60.0f;
+        glm::vec3 target(std::sin(t * 0.7f) * 12.0f, 0.6f, std::cos(t * 0.5f) * 9.0f);
+        float yaw = t * 0.9f;
+        glm::vec3 eye = target + glm::vec3(std::sin(yaw) * 14.0f, 4.0f, std::cos(yaw) * 14.0f);
+        glm::mat4 view = glm::lookAt(eye, target, glm::vec3(0, 1, 0));
+
+        float sliceNear = nearZ;
+        for (int c = 0; c < count; ++c)
+        {
+            glm::vec3 corners[8];
+            FrustumSliceCorners(view, proj, sliceNear, splitFar[c], corners);
+            sliceNear = splitFar[c];
+            glm::mat4 vp = FitCascade(corners, sunDir, sizes[c], 40.0f);
+            glm::mat4 cached = FitCascade(corners, sunDir, sizes[c], 40.0f, cacheSnap);
+            for (const glm::vec3 &p : corners)
+            {
+                for (const glm::mat4 *m : {&vp, &cached})
+                {
+                    glm::vec4 q = *m * glm::vec4(p, 1.0f);
+                    if (std::fabs(q.x) > 1.0001f || std::fabs(q.y) > 1.0001f || std::fabs(q.z) > 1.0001f)
+                        ++outside;
+                }
+            }
+            if (f == 0 || cached != lastCached[c])
+                ++cachedRebuilds[c];
+            lastCached[c] = cached;
+            // texel position of a fixed world point
+            glm::vec4 q = vp * glm::vec4(probe, 1.0f);
+            glm::vec2 texel = (glm::vec2(q) * 0.5f + 0.5f) * (float)sizes[c];
+            glm::vec2 frac = texel - glm::floor(texel);
+            float scale = vp[0][0];
+            if (f > 0 && scale == lastScale[c])
+            {
+                glm::vec2 d = glm::abs(frac - lastFrac[c]);
+                d = glm::min(d, 1.0f - d); // 0.999 and 0.001 are the same position
+                maxDrift = std::max(maxDrift, std::max(d.x, d.y));
+            }
+            else if (f > 0)
+                ++resized;
+            lastFrac[c] = frac;
+            lastScale[c] = scale;
+        }
+    }
+    std::cout << "Cascade check: " << frames << " frames, " << count << " cascades, splits";
+    for (int c = 0; c < count; ++c)
+        std::cout << " " << splitFar[c];
+    std::cout << "\n  corners outside their cascade: " << outside << "\n  cascade resizes: " << resized
+              << "\n  max sub-texel drift while not resized: " << maxDrift << " texels\n";
+    std::cout << "  static layer rebuilds with a " << cacheSnap << "-texel snap:";
+    for (int c = 0; c < count; ++c)
+        std::cout << " " << cachedRebuilds[c];
+    std::cout << " (of " << frames << " frames)\n";
+    return (outside == 0 && maxDrift < 0.01f) ? 0 : 1;
+}
+
+// Read one attribute of a packed vertex back the way the vertex shaders see it
+static glm::vec3 ReadAttrib(const PackedVertices &pv, const VertexAttrib &a, size_t vertex)
+{
+    const uint8_t *p = pv.bytes.data() + vertex * pv.stride + a.offset;
+    glm::vec3 v(0.0f);
+    for (int c = 0; c < std::min(a.components, 3); ++c)
+    {
+        if (a.type == VERTEX_ATTRIB_FLOAT)
+            std::memcpy(&v[c], p + c * 4, 4);
+        else if (a.type == VERTEX_ATTRIB_SHORT)
+        {
+            int16_t q;
+            std::memcpy(&q, p + c * 2, 2);
+            v[c] = (float)q;
+        }
+        else if (a.type == VERTEX_ATTRIB_HALF)
+        {
+            uint16_t h;
+            std::memcpy(&h, p + c * 2, 2);
+            v[c] = HalfToFloat(h);
+        }
+    }
+    return v;
+}
+
+// Packs every mesh of the game's models in the full-float layout and both compressed ones,
+// as StaticModel::Upload does, and reports GPU bytes (vertices + depth positions + indices),
+// encode time and the worst decoded error against the loaded data.
+static int RunVertexFormatBench(const Game &game)
+{
+    const ModelData *models[] = {&game.floorModel, &game.playerModel, &game.fallingModels[0],
+                                 &game.fallingModels[1], &game.fallingModels[2]};
+    const char *names[] = {"full", "octahedral", "1010102"};
+    using Clock = std::chrono::high_resolution_clock;
+    size_t fullBytes = 0;
+    bool ok = true;
+    std::cout << "Vertex format bench:\n";
+    for (const char *name : names)
+    {
+        VertexFormat format;
+        VertexFormatFromName(name, format);
+        size_t vertexBytes = 0, depthBytes = 0, indexBytes = 0, vertices = 0, shortMeshes = 0, meshes = 0;
+        float posErr = 0.0f, normalErr = 0.0f, uvErr = 0.0f;
+        double encodeMs = 0.0;
+        for (const ModelData *model : models)
+        {
+            for (size_t m = 0; m < model->meshes.size(); ++m)
+            {
+                const MeshData &mesh = model->meshes[m];
+                LocalBox bounds = m < model->collision.meshBox.size() ? model->collision.meshBox[m] : model->collision.box;
+                PackedVertices pv;
+                PackedIndices pi;
+                std::vector<int16_t> depth16;
+                std::vector<glm::vec3> depth32;
+                auto t0 = Clock::now();
+                PackVertices(mesh.vertices, bounds, format, pv);
+                PackIndices(mesh.indices, mesh.vertices.size(), format, pi);
+                if (format.quantizePositions)
+                    QuantizePositions(mesh.vertices, bounds, depth16);
+                else
+                    PackPositions(mesh.vertices, depth32);
+                encodeMs += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+                vertexBytes += pv.bytes.size();
+                depthBytes += depth16.size() * sizeof(int16_t) + depth32.size() * sizeof(glm::vec3);
+                indexBytes += pi.bytes.size();
+                vertices += mesh.vertices.size();
+                shortMeshes += pi.shortIndices;
+                ++meshes;
+
+                for (size_t i = 0; i < mesh.vertices.size(); ++i)
+                {
+                    const SimpleVertex &v = mesh.vertices[i];
+                    glm::vec3 pos = ReadAttrib(pv, pv.position, i) * pv.decode.scale + pv.decode.offset;
+                    posErr = std::max(posErr, glm::length(pos - v.pos));
+
+                    glm::vec3 n;
+                    uint32_t packed;
+                    std::memcpy(&packed, pv.bytes.data() + i * pv.stride + pv.normal.offset, 4);
+                    if (format.normals == NORMAL_ENCODING_OCTAHEDRAL)
+                        n = DecodeOctahedral(packed);
+                    else if (format.normals == NORMAL_ENCODING_INT_2_10_10_10)
+                        n = DecodeInt2_10_10_10(packed);
+                    else
+                        n = ReadAttrib(pv, pv.normal, i);
+                    float len = glm::length(v.normal);
+                    if (len > 0.5f)
+                    {
+                        float cosAngle = glm::clamp(glm::dot(n, v.normal / len), -1.0f, 1.0f);
+                        normalErr = std::max(normalErr, glm::degrees(std::acos(cosAngle)));
+                    }
+
+                    glm::vec2 uv = glm::vec2(ReadAttrib(pv, pv.uv, i));
+                    uvErr = std::max(uvErr, std::max(std::fabs(uv.x - v.uv.x), std::fabs(uv.y - v.uv.y)));
+                }
+            }
+        }
+        size_t total = vertexBytes + depthBytes + indexBytes;
+        if (fullBytes == 0)
+            fullBytes = total;
+        std::cout << "  " << name << ": " << total / 1024 << " KB (" << 100.0 * total / std::max<size_t>(fullBytes, 1)
+                  << "% of full; vertices " << vertexBytes / 1024 << ", depth positions " << depthBytes / 1024
+                  << ", indices " << indexBytes / 1024 << " KB), " << vertices << " vertices, " << shortMeshes << "/"
+                  << meshes << " meshes with 16-bit indices, encode " << encodeMs << " ms\n"
+                  << "    max error: position " << posErr << ", normal " << normalErr << " deg, uv " << uvErr << "\n";
+        // 16-bit octahedral normals land within hundredths of a degree, 10-bit ones within about a tenth
+        ok = ok && normalErr < 1.0f && uvErr < 1.0f / 1024.0f;
+    }
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    std::string replayPath;
+    long ticks = 0;
+    long satBoxes = 0;
+    long hullPairs = 0;
+    long cullSpheres = 0;
+    long cascadeFrames = 0;
+    long propCount = 0;
+    bool benchVertexFormats = false;
+    uint32_t seed = 1;
+    bool serial = false;
+    bool ccd = false;
+    bool noProps = false;
+    bool noAxisCache = false;
+    bool noHull = false;
+    bool noTimers = false;
+    bool benchBroadphase = false;
+    bool checkBroadphase = false;
+    float simHz = 60.0f;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            ticks = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--serial") == 0)
+            serial = true;
+        else if (std::strcmp(argv[i], "--hz") == 0 && i + 1 < argc)
+            simHz = (float)std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--ccd") == 0)
+            ccd = true;
+        else if (std::strcmp(argv[i], "--no-props") == 0)
+            noProps = true;
+        else if (std::strcmp(argv[i], "--no-axis-cache") == 0)
+            noAxisCache = true;
+        else if (std::strcmp(argv[i], "--no-hull") == 0)
+            noHull = true;
+        else if (std::strcmp(argv[i], "--no-timers") == 0)
+            noTimers = true;
+        else if (std::strcmp(argv[i], "--check-hull") == 0 && i + 1 < argc)
+            hullPairs = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--check-sat") == 0 && i + 1 < argc)
+            satBoxes = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--bench-broadphase") == 0)
+            benchBroadphase = true;
+        else if (std::strcmp(argv[i], "--check-broadphase") == 0)
+            checkBroadphase = true;
+        else if (std::strcmp(argv[i], "--check-cull") == 0 && i + 1 < argc)
+            cullSpheres = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--check-cascades") == 0 && i + 1 < argc)
+            cascadeFrames = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--check-props") == 0 && i + 1 < argc)
+            propCount = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--bench-vertex-formats") == 0)
+            benchVertexFormats = true;
+    }
+    if (satBoxes > 0)
+        return RunSatCheck(satBoxes);
+    if (benchBroadphase || checkBroadphase)
+        return RunBroadphaseBench(benchBroadphase);
+    if (cullSpheres > 0)
+        return RunCullCheck(cullSpheres);
+    if (cascadeFrames > 0)
+        return RunCascadeCheck(cascadeFrames);
+    if (propCount > 0)
+        return RunPropCheck(propCount);
+    if (replayPath.empty() && ticks <= 0 && !benchVertexFormats && hullPairs <= 0)
+    {
+        std::cerr << "usage: HelloGLSim --replay <file> | --ticks <N> [--seed <S>] [--serial] [--hz <rate>] [--ccd] [--no-props] [--no-axis-cache] [--no-hull] [--no-timers] | --check-sat <N> | --check-hull <N> | --bench-broadphase | --check-broadphase | --check-cull <N> | --check-cascades <N> | --check-props <N> | --bench-vertex-formats\n";
+        return 2;
+    }
+
+    // the simulation only needs model bounds, so skip keeping vertex data around (unless
+    // the hulls or vertex formats are to be checked)
+    std::string base = GetExecutableDir();
+    bool keepGeometry = benchVertexFormats || hullPairs > 0;
+    Game game;
+    game.parallelUpdate = !serial;
+    game.continuousCollision = ccd;
+    game.keepLanded = !noProps;
+    game.separatingAxisCache = !noAxisCache;
+    game.hullNarrowphase = !noHull;
+    game.landingTimers = !noTimers;
+    if (!game.LoadResources(base + "/assets", keepGeometry))
+        return 1;
+    game.LoadPlayerModel(base + "/assets/models/walk_cat.obj", keepGeometry);
+    game.playerModel.modelScale = glm::vec3(0.5f); // same as HelloGL
+    if (hullPairs > 0)
+    {
+        int synthetic = RunHullCheck(hullPairs);
+        int models = RunModelHullCheck(game, hullPairs);
+        return (synthetic == 0 && models == 0) ? 0 : 1;
+    }
+    if (benchVertexFormats)
+        return RunVertexFormatBench(game);
+
+    if (!replayPath.empty())
+    {
+        // only --serial, --no-axis-cache and --no-timers apply: the rest change outcomes, so the
+        // recording's own settings are used
+        if (ccd || noProps || noHull)
+            std::cerr << "HelloGLSim: --ccd, --no-props and --no-hull are ignored with --replay\n";
+        return RunReplay(replayPath, game) ? 0 : 1;
+    }
+
+    game.fixedSeed = true;
+    game.seed = seed;
+    if (simHz > 0.0f)
+        game.simHz = simHz;
+    return RunSoak(game, ticks);
+}
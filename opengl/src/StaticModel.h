@@ -4,13 +4,17 @@
 #include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
-#include <assimp/scene.h>
+#include "ModelData.h"
+#include "Shader.h"
+#include "DrawList.h"
+#include "Culling.h"
+#include "VertexPacking.h"
 
-struct SimpleVertex
+// Per-instance attributes for instanced draws (locations 3..6 = model matrix, 7 = tint)
+struct InstanceData
 {
-    glm::vec3 pos;
-    glm::vec3 normal;
-    glm::vec2 uv;
+    glm::mat4 model;
+    glm::vec3 color;
 };
 
 struct MeshRenderData
@@ -19,6 +23,16 @@ struct MeshRenderData
     GLuint vbo = 0;
     GLuint ebo = 0;
     GLsizei indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT; // GL_UNSIGNED_SHORT where the vertex count allows
+    // position-only stream for depth-only passes. Shares ebo; its instance attributes come
+    // from a separate buffer so the shadow pass can cull on its own
+    GLuint depthVao = 0;
+    GLuint depthVbo = 0;
+    // both streams' positions may be 16-bit relative to bounds: shaders decode them with
+    // uPosScale/uPosOffset set from this
+    PositionDecode positionDecode;
+    size_t gpuBytes = 0; // vbo + depthVbo + ebo
+    LocalBox bounds; // model-local box of this mesh (from ModelData's collision data)
 
     // material
     bool hasDiffuse = false;
@@ -36,13 +50,27 @@ public:
     StaticModel();
     ~StaticModel();
 
-    // Load model via Assimp (.obj/.fbx/.gltf/.glb)
-    bool LoadFromFile(const std::string &path);
+    // Create VAOs/buffers/textures from CPU-side model data (geometry must still be present)
+    bool Upload(const ModelData &data);
+    // vertex/index layout of the uploaded buffers (see VertexPacking.h); set before Upload, and
+    // build phong.vs with VertexFormatDefines of the same format
+    VertexFormat vertexFormat;
+    // vertex + index bytes uploaded to the GPU by the last Upload
+    size_t GeometryBytes() const;
 
-    // Draw with currently bound shader. Caller must set uModel, uNormalMat, and shader must
-    // support uHasDiffuse, uHasAlpha, uUseAlphaTest, uAlphaCutoff, uMatDiffuse, and sampler2D uDiffuseMap.
-    void Draw(GLuint shaderProgram) const;
-    void DrawDepth() const;
+    // Instanced items take their per-instance model matrix and tint from the buffers attached
+    // here (laid out as InstanceData): instanceVBO feeds the main pass, depthInstanceVBO the
+    // depth-only passes. DrawList sets uInstanced and the per-mesh position decode.
+    void AttachInstanceBuffers(GLuint instanceVBO, GLuint depthInstanceVBO);
+    // Make depth-only instanced draws start at instance firstInstance of depthInstanceVBO
+    // (one buffer holds every shadow cascade's casters back to back)
+    void SetDepthInstanceOffset(GLuint depthInstanceVBO, size_t firstInstance);
+    // Queue every mesh on the frame draw list (see DrawList), the only way models are drawn. transform
+    // indexes the list's transforms for single draws; instanceCount > 0 draws instanced.
+    // With cull given, single-draw meshes whose world box lies outside it are left out.
+    void Submit(DrawList &list, DrawPass pass, const Shader &shader, uint32_t transform,
+                GLsizei instanceCount, float viewDepth,
+                const Frustum *cull = nullptr, CullStats *stats = nullptr) const;
     GLuint getDiffuseTexID() const;
     // convenience scale
     glm::vec3 modelScale = glm::vec3(1.0f);
@@ -50,16 +78,13 @@ public:
     glm::vec3 bboxMin = glm::vec3(0.0f);
     glm::vec3 bboxMax = glm::vec3(0.0f);
     bool bboxInitialized = false;
+    BoundingSphere boundingSphere; // model-local, for per-instance culling
 
 private:
     std::vector<MeshRenderData> meshes;
-    std::string directory;
 
     void Cleanup();
 
     // helper to load texture file, returns 0 on failure
     static GLuint LoadTextureFromFile(const std::string &filename, bool &outHasAlpha, bool silent);
-    void ComputeBBoxRecursive(aiNode *node,
-                              const aiScene *scene,
-                              const glm::mat4 &parentTransform);
 };
@@ -0,0 +1,95 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int workerCount)
+{
+    if (workerCount < 0)
+    {
+        unsigned hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? (int)hw - 1 : 0;
+    }
+    workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : workers)
+        t.join();
+}
+
+void ThreadPool::DrainChunks()
+{
+    for (;;)
+    {
+        size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= jobChunks)
+            return;
+        jobFn(jobCtx, chunk);
+        if (finishedChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == jobChunks)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]
+                      { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            ++busyWorkers;
+        }
+        DrainChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkers;
+        }
+        done.notify_all();
+    }
+}
+
+void ThreadPool::RunJob(size_t chunkCount, JobFn fn, void *ctx)
+{
+    if (chunkCount == 0)
+        return;
+    if (workers.empty() || chunkCount == 1)
+    {
+        for (size_t c = 0; c < chunkCount; ++c)
+            fn(ctx, c);
+        return;
+    }
+
+    {
+        // a late worker may still be leaving the previous job; never reset the counters under it
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]
+                  { return busyWorkers == 0; });
+        jobFn = fn;
+        jobCtx = ctx;
+        jobChunks = chunkCount;
+        nextChunk.store(0, std::memory_order_relaxed);
+        finishedChunks.store(0, std::memory_order_relaxed);
+        ++generation;
+    }
+    wake.notify_all();
+
+    DrainChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]
+              { return finishedChunks.load(std::memory_order_acquire) == jobChunks && busyWorkers == 0; });
+}
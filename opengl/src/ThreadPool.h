@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker pool for data-parallel loops.
+// Workers sleep between jobs; the calling thread also takes chunks, so a pool with
+// zero workers simply runs everything inline.
+class ThreadPool
+{
+public:
+    // workerCount < 0 picks hardware_concurrency() - 1
+    explicit ThreadPool(int workerCount = -1);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t WorkerCount() const { return workers.size(); }
+
+    // Calls fn(chunkIndex) for every chunk in [0, chunkCount) and returns when all are done.
+    // Which thread runs a chunk is unspecified, so fn must only write chunk-local data.
+    template <typename F>
+    void Run(size_t chunkCount, F &&fn)
+    {
+        RunJob(chunkCount, &Invoke<typename std::remove_reference<F>::type>, &fn);
+    }
+
+private:
+    using JobFn = void (*)(void *ctx, size_t chunk);
+
+    template <typename F>
+    static void Invoke(void *ctx, size_t chunk) { (*static_cast<F *>(ctx))(chunk); }
+
+    void RunJob(size_t chunkCount, JobFn fn, void *ctx);
+    void WorkerLoop();
+    void DrainChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+    unsigned generation = 0; // bumped for every job so sleeping workers notice new work
+    int busyWorkers = 0;     // workers inside DrainChunks; a new job waits until this is 0
+
+    // current job (valid while a Run is in flight)
+    JobFn jobFn = nullptr;
+    void *jobCtx = nullptr;
+    size_t jobChunks = 0;
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> finishedChunks{0};
+};
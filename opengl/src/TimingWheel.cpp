@@ -0,0 +1,82 @@
+// src/TimingWheel.cpp
+#include "TimingWheel.h"
+
+TimingWheel::TimingWheel(uint32_t capacity, uint32_t bucketCount)
+{
+    uint32_t buckets = 1;
+    while (buckets < bucketCount)
+        buckets <<= 1;
+    mask = buckets - 1;
+    head.assign(buckets, NIL);
+    SetCapacity(capacity);
+}
+
+void TimingWheel::SetCapacity(uint32_t capacity)
+{
+    next.assign(capacity, NIL);
+    prev.assign(capacity, UNLINKED);
+    due.assign(capacity, 0);
+    tags.assign(capacity, 0);
+    Clear(current);
+}
+
+void TimingWheel::Clear(uint64_t now)
+{
+    current = now;
+    pending = 0;
+    head.assign(head.size(), NIL);
+    prev.assign(prev.size(), UNLINKED);
+}
+
+void TimingWheel::Unlink(uint32_t id)
+{
+    uint32_t p = prev[id], n = next[id];
+    if (p >= BucketLink(mask) && p <= BucketLink(0))
+        head[BucketLink(0) - p] = n;
+    else
+        next[p] = n;
+    if (n != NIL)
+        prev[n] = p;
+    prev[id] = UNLINKED;
+    --pending;
+}
+
+void TimingWheel::Schedule(uint32_t id, uint64_t when, uint32_t tag)
+{
+    if (Pending(id))
+        Unlink(id);
+    // overdue timers go into the next tick's bucket
+    if (when <= current)
+        when = current + 1;
+    uint32_t bucket = (uint32_t)(when & mask);
+    due[id] = when;
+    tags[id] = tag;
+    next[id] = head[bucket];
+    prev[id] = BucketLink(bucket);
+    if (head[bucket] != NIL)
+        prev[head[bucket]] = id;
+    head[bucket] = id;
+    ++pending;
+}
+
+void TimingWheel::Cancel(uint32_t id)
+{
+    if (id < prev.size() && Pending(id))
+        Unlink(id);
+}
+
+void TimingWheel::Advance(std::vector<TimerEvent> &fired)
+{
+    ++current;
+    uint32_t id = head[current & mask];
+    while (id != NIL)
+    {
+        uint32_t n = next[id];
+        if (due[id] <= current)
+        {
+            fired.push_back({id, tags[id]});
+            Unlink(id);
+        }
+        id = n;
+    }
+}
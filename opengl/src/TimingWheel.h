@@ -0,0 +1,57 @@
+// src/TimingWheel.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A timer that came due: the id it was scheduled under and the tag given with it
+struct TimerEvent
+{
+    uint32_t id;
+    uint32_t tag;
+};
+
+// Hashed timing wheel (Varghese & Lauck): one timer per small integer id, firing on an
+// absolute tick. Each Advance visits a single bucket, so a tick costs the timers hashed
+// to that bucket rather than every pending timer; timers more than one lap away stay in
+// their bucket and are skipped until their lap comes round.
+// Timers are intrusive lists over per-id arrays sized by SetCapacity, so Schedule, Cancel
+// and Advance never allocate (as long as fired has room for the timers that come due).
+class TimingWheel
+{
+public:
+    // bucketCount is rounded up to a power of two
+    explicit TimingWheel(uint32_t capacity = 0, uint32_t bucketCount = 256);
+
+    // ids in [0, capacity); drops every timer
+    void SetCapacity(uint32_t capacity);
+    // drop every timer and restart the clock at tick now
+    void Clear(uint64_t now = 0);
+    uint64_t Now() const { return current; }
+
+    // (Re)arm id to fire on tick due; due <= Now() fires on the next Advance.
+    // tag is handed back with the event (e.g. a generation to spot ids that were reused).
+    void Schedule(uint32_t id, uint64_t due, uint32_t tag = 0);
+    void Cancel(uint32_t id);
+    bool Pending(uint32_t id) const { return prev[id] != UNLINKED; }
+    size_t PendingCount() const { return pending; }
+
+    // Step the clock one tick and append every timer due on it to fired
+    void Advance(std::vector<TimerEvent> &fired);
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;          // end of a bucket list
+    static constexpr uint32_t UNLINKED = UINT32_MAX - 1; // prev[] of an id with no timer
+
+    // prev[id] of a bucket's first timer encodes the bucket, so unlinking needs no search
+    static uint32_t BucketLink(uint32_t bucket) { return UINT32_MAX - 2 - bucket; }
+    void Unlink(uint32_t id);
+
+    uint64_t current = 0;
+    uint32_t mask = 0;
+    size_t pending = 0;
+    std::vector<uint32_t> head;          // per bucket: first id or NIL
+    std::vector<uint32_t> next, prev;    // per id: bucket list links
+    std::vector<uint64_t> due;
+    std::vector<uint32_t> tags;
+};
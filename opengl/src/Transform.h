@@ -0,0 +1,40 @@
+// src/Transform.h
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Rotation matrix of a unit quaternion, written out directly (columns are the rotated axes)
+inline glm::mat3 QuatToMat3(const glm::quat &q)
+{
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    glm::mat3 r;
+    r[0] = glm::vec3(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy));
+    r[1] = glm::vec3(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx));
+    r[2] = glm::vec3(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+    return r;
+}
+
+// translate(pos) * rotate * scale(scale), filled in column by column (no 4x4 multiplies)
+inline glm::mat4 ComposeTRS(const glm::vec3 &pos, const glm::mat3 &rot, const glm::vec3 &scale)
+{
+    glm::mat4 m;
+    m[0] = glm::vec4(rot[0] * scale.x, 0.0f);
+    m[1] = glm::vec4(rot[1] * scale.y, 0.0f);
+    m[2] = glm::vec4(rot[2] * scale.z, 0.0f);
+    m[3] = glm::vec4(pos, 1.0f);
+    return m;
+}
+
+// Normalized lerp along the shorter arc; plenty for the small per-tick rotations we blend
+inline glm::quat QuatNlerp(const glm::quat &a, const glm::quat &b, float t)
+{
+    float sign = (glm::dot(a, b) < 0.0f) ? -1.0f : 1.0f;
+    glm::quat q(a.w + (sign * b.w - a.w) * t,
+                a.x + (sign * b.x - a.x) * t,
+                a.y + (sign * b.y - a.y) * t,
+                a.z + (sign * b.z - a.z) * t);
+    return glm::normalize(q);
+}
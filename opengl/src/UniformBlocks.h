@@ -0,0 +1,45 @@
+// src/UniformBlocks.h
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "ShadowCascades.h"
+
+// Per-frame data shared by every program through uniform buffers at fixed binding points.
+// Layouts mirror the std140 blocks declared in the shaders (vec3s are padded to vec4).
+enum UniformBlockBinding : GLuint
+{
+    FRAME_BLOCK_BINDING = 0, // FrameData: camera
+    LIGHT_BLOCK_BINDING = 1, // LightData: sun
+};
+
+// layout(std140) uniform FrameData
+struct FrameBlock
+{
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::vec4 viewPos; // xyz = camera position
+};
+
+// layout(std140) uniform LightData
+struct LightBlock
+{
+    glm::mat4 cascadeVP[MAX_CASCADES]; // light view-projection of each shadow cascade
+    glm::vec4 cascadeSplits;           // view distance where each cascade ends
+    glm::vec4 lightDir;                // xyz = direction the light travels (unit)
+    glm::vec4 lightColor;              // rgb = color, a = intensity
+    glm::ivec4 shadowParams;           // x = cascade count
+};
+
+static_assert(sizeof(FrameBlock) == 144, "FrameBlock must match the std140 FrameData layout");
+static_assert(sizeof(LightBlock) == 64 * MAX_CASCADES + 64, "LightBlock must match the std140 LightData layout");
+
+// Point the program's FrameData/LightData blocks (whichever it declares) at their binding points
+inline void BindUniformBlocks(GLuint program)
+{
+    GLuint frame = glGetUniformBlockIndex(program, "FrameData");
+    if (frame != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, frame, FRAME_BLOCK_BINDING);
+    GLuint light = glGetUniformBlockIndex(program, "LightData");
+    if (light != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, light, LIGHT_BLOCK_BINDING);
+}
@@ -0,0 +1,265 @@
+// src/VertexPacking.cpp
+#include "VertexPacking.h"
+#include <cmath>
+#include <cstring>
+
+// half floats keep 11 significant bits: above this UVs lose more than about a texel of a
+// 1024 texture, so such meshes keep float UVs
+static constexpr float HALF_UV_LIMIT = 2.0f;
+
+VertexFormat FullFloatVertexFormat()
+{
+    VertexFormat format;
+    format.quantizePositions = false;
+    format.normals = NORMAL_ENCODING_FLOAT;
+    format.halfUVs = false;
+    format.shortIndices = false;
+    return format;
+}
+
+bool VertexFormatFromName(const char *name, VertexFormat &format)
+{
+    if (std::strcmp(name, "full") == 0)
+        format = FullFloatVertexFormat();
+    else if (std::strcmp(name, "octahedral") == 0)
+        format = VertexFormat();
+    else if (std::strcmp(name, "1010102") == 0)
+    {
+        format = VertexFormat();
+        format.normals = NORMAL_ENCODING_INT_2_10_10_10;
+    }
+    else
+        return false;
+    return true;
+}
+
+std::string VertexFormatDefines(const VertexFormat &format)
+{
+    return "#define NORMAL_ENCODING " + std::to_string((int)format.normals) + "\n";
+}
+
+// ===== Scalar codecs =====
+
+static float SignNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+static int16_t ToSnorm16(float v)
+{
+    return (int16_t)std::lround(glm::clamp(v, -1.0f, 1.0f) * 32767.0f);
+}
+
+uint32_t EncodeOctahedral(const glm::vec3 &n)
+{
+    // project onto the octahedron |x| + |y| + |z| = 1, fold the lower half over the diagonals
+    glm::vec3 a = glm::abs(n);
+    float l1 = a.x + a.y + a.z;
+    glm::vec2 p = l1 > 0.0f ? glm::vec2(n.x, n.y) / l1 : glm::vec2(0.0f);
+    if (n.z < 0.0f)
+        p = glm::vec2((1.0f - std::fabs(p.y)) * SignNotZero(p.x), (1.0f - std::fabs(p.x)) * SignNotZero(p.y));
+    uint16_t x = (uint16_t)ToSnorm16(p.x), y = (uint16_t)ToSnorm16(p.y);
+    return (uint32_t)x | ((uint32_t)y << 16);
+}
+
+glm::vec3 DecodeOctahedral(uint32_t packed)
+{
+    glm::vec2 e((float)(int16_t)(packed & 0xFFFF) / 32767.0f, (float)(int16_t)(packed >> 16) / 32767.0f);
+    glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+    float t = glm::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+uint32_t EncodeInt2_10_10_10(const glm::vec3 &n)
+{
+    uint32_t packed = 0;
+    for (int a = 0; a < 3; ++a)
+    {
+        int v = (int)std::lround(glm::clamp(n[a], -1.0f, 1.0f) * 511.0f);
+        packed |= ((uint32_t)v & 0x3FF) << (10 * a);
+    }
+    return packed; // w = 0
+}
+
+glm::vec3 DecodeInt2_10_10_10(uint32_t packed)
+{
+    glm::vec3 n;
+    for (int a = 0; a < 3; ++a)
+    {
+        int v = (int)((packed >> (10 * a)) & 0x3FF);
+        if (v & 0x200)
+            v -= 0x400; // sign-extend
+        n[a] = (float)v / 511.0f;
+    }
+    return glm::normalize(n);
+}
+
+uint16_t FloatToHalf(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, 4);
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exp = (int)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mant = bits & 0x7FFFFF;
+    if (((bits >> 23) & 0xFF) == 0xFF) // inf / nan
+        return (uint16_t)(sign | 0x7C00 | (mant ? 0x200 : 0));
+    if (exp >= 31)
+        return (uint16_t)(sign | 0x7C00);
+    if (exp <= 0)
+    {
+        // subnormal half (or zero)
+        if (exp < -10)
+            return (uint16_t)sign;
+        mant |= 0x800000;
+        int shift = 14 - exp;
+        uint32_t h = mant >> shift;
+        uint32_t rest = mant & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (h & 1)))
+            ++h;
+        return (uint16_t)(sign | h);
+    }
+    // round to nearest even; a carry into the exponent is still the right value
+    uint32_t h = ((uint32_t)exp << 10) | (mant >> 13);
+    uint32_t rest = mant & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (h & 1)))
+        ++h;
+    return (uint16_t)(sign | h);
+}
+
+float HalfToFloat(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t bits;
+    if (exp == 0)
+    {
+        float f = std::ldexp((float)mant, -24);
+        return sign ? -f : f;
+    }
+    if (exp == 31)
+        bits = sign | 0x7F800000 | (mant << 13);
+    else
+        bits = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+    float f;
+    std::memcpy(&f, &bits, 4);
+    return f;
+}
+
+// ===== Streams =====
+
+void PackPositions(const std::vector<SimpleVertex> &verts, std::vector<glm::vec3> &out)
+{
+    out.resize(verts.size());
+    for (size_t i = 0; i < verts.size(); ++i)
+        out[i] = verts[i].pos;
+}
+
+PositionDecode QuantizePositions(const std::vector<SimpleVertex> &verts, const LocalBox &bounds,
+                                 std::vector<int16_t> &out)
+{
+    PositionDecode decode;
+    decode.offset = bounds.center;
+    decode.scale = bounds.half / 32767.0f;
+
+    // a flat axis (the floor's y) encodes as 0
+    glm::vec3 inv(0.0f);
+    for (int a = 0; a < 3; ++a)
+        inv[a] = bounds.half[a] > 0.0f ? 32767.0f / bounds.half[a] : 0.0f;
+
+    out.resize(verts.size() * 4);
+    for (size_t i = 0; i < verts.size(); ++i)
+    {
+        glm::vec3 q = glm::clamp((verts[i].pos - bounds.center) * inv, -32767.0f, 32767.0f);
+        for (int a = 0; a < 3; ++a)
+            out[i * 4 + a] = (int16_t)std::lround(q[a]);
+        out[i * 4 + 3] = 0;
+    }
+    return decode;
+}
+
+void PackVertices(const std::vector<SimpleVertex> &verts, const LocalBox &bounds, const VertexFormat &format,
+                  PackedVertices &out)
+{
+    bool halfUVs = format.halfUVs;
+    for (size_t i = 0; i < verts.size() && halfUVs; ++i)
+        halfUVs = std::fabs(verts[i].uv.x) <= HALF_UV_LIMIT && std::fabs(verts[i].uv.y) <= HALF_UV_LIMIT;
+
+    // layout: position | normal | uv, each 4-byte aligned
+    size_t offset = 0;
+    out.position = {format.quantizePositions ? VERTEX_ATTRIB_SHORT : VERTEX_ATTRIB_FLOAT,
+                    format.quantizePositions ? 4 : 3, offset};
+    offset += format.quantizePositions ? 8 : 12;
+    switch (format.normals)
+    {
+    case NORMAL_ENCODING_OCTAHEDRAL:
+        out.normal = {VERTEX_ATTRIB_SHORT, 2, offset};
+        offset += 4;
+        break;
+    case NORMAL_ENCODING_INT_2_10_10_10:
+        out.normal = {VERTEX_ATTRIB_INT_2_10_10_10, 4, offset};
+        offset += 4;
+        break;
+    default:
+        out.normal = {VERTEX_ATTRIB_FLOAT, 3, offset};
+        offset += 12;
+        break;
+    }
+    out.uv = {halfUVs ? VERTEX_ATTRIB_HALF : VERTEX_ATTRIB_FLOAT, 2, offset};
+    offset += halfUVs ? 4 : 8;
+    out.stride = offset;
+
+    std::vector<int16_t> positions;
+    if (format.quantizePositions)
+        out.decode = QuantizePositions(verts, bounds, positions);
+    else
+        out.decode = PositionDecode();
+
+    out.bytes.assign(verts.size() * out.stride, 0);
+    for (size_t i = 0; i < verts.size(); ++i)
+    {
+        const SimpleVertex &v = verts[i];
+        uint8_t *dst = out.bytes.data() + i * out.stride;
+        if (format.quantizePositions)
+            std::memcpy(dst + out.position.offset, &positions[i * 4], 8);
+        else
+            std::memcpy(dst + out.position.offset, &v.pos, 12);
+
+        if (format.normals == NORMAL_ENCODING_OCTAHEDRAL)
+        {
+            uint32_t n = EncodeOctahedral(v.normal);
+            std::memcpy(dst + out.normal.offset, &n, 4);
+        }
+        else if (format.normals == NORMAL_ENCODING_INT_2_10_10_10)
+        {
+            uint32_t n = EncodeInt2_10_10_10(v.normal);
+            std::memcpy(dst + out.normal.offset, &n, 4);
+        }
+        else
+            std::memcpy(dst + out.normal.offset, &v.normal, 12);
+
+        if (halfUVs)
+        {
+            uint16_t uv[2] = {FloatToHalf(v.uv.x), FloatToHalf(v.uv.y)};
+            std::memcpy(dst + out.uv.offset, uv, 4);
+        }
+        else
+            std::memcpy(dst + out.uv.offset, &v.uv, 8);
+    }
+}
+
+void PackIndices(const std::vector<unsigned int> &inds, size_t vertexCount, const VertexFormat &format,
+                 PackedIndices &out)
+{
+    out.shortIndices = format.shortIndices && vertexCount <= 65536;
+    if (!out.shortIndices)
+    {
+        out.bytes.resize(inds.size() * sizeof(unsigned int));
+        if (!inds.empty())
+            std::memcpy(out.bytes.data(), inds.data(), out.bytes.size());
+        return;
+    }
+    out.bytes.resize(inds.size() * sizeof(uint16_t));
+    uint16_t *dst = reinterpret_cast<uint16_t *>(out.bytes.data());
+    for (size_t i = 0; i < inds.size(); ++i)
+        dst[i] = (uint16_t)inds[i];
+}
@@ -0,0 +1,101 @@
+// src/VertexPacking.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Collision.h"
+#include "ModelData.h"
+
+// GPU vertex stream encoders, without GL: StaticModel uploads their output, HelloGLSim
+// checks the round trip and measures the sizes.
+
+// Shaders decode a packed position as q * scale + offset (q read as plain integers)
+struct PositionDecode
+{
+    glm::vec3 scale = glm::vec3(1.0f);
+    glm::vec3 offset = glm::vec3(0.0f);
+};
+
+enum NormalEncoding : uint8_t
+{
+    NORMAL_ENCODING_FLOAT = 0,          // 3 floats, 12 bytes
+    NORMAL_ENCODING_OCTAHEDRAL = 1,     // octahedral map, 2 x int16, 4 bytes
+    NORMAL_ENCODING_INT_2_10_10_10 = 2, // 3 x 10-bit signed ints (GL_INT_2_10_10_10_REV), 4 bytes
+};
+
+// Vertex layout the renderer picks at load. The normal encoding is compiled into phong.vs
+// (VertexFormatDefines), so it holds for every mesh; the other fields fall back per mesh
+// where the data doesn't fit (UVs too large for halves, too many vertices for short indices).
+struct VertexFormat
+{
+    bool quantizePositions = true; // int16 relative to the mesh bounds (8 bytes) instead of floats (12)
+    NormalEncoding normals = NORMAL_ENCODING_OCTAHEDRAL;
+    bool halfUVs = true;      // 2 half floats (4 bytes) instead of floats (8)
+    bool shortIndices = true; // 16-bit indices where the mesh has at most 65536 vertices
+};
+
+// SimpleVertex as loaded, with 32-bit indices
+VertexFormat FullFloatVertexFormat();
+// "full", "octahedral" or "1010102" (the last two fully compressed); false if unknown
+bool VertexFormatFromName(const char *name, VertexFormat &format);
+// "#define NORMAL_ENCODING n" to build phong.vs with
+std::string VertexFormatDefines(const VertexFormat &format);
+
+// ===== Interleaved vertices =====
+
+enum VertexAttribType : uint8_t
+{
+    VERTEX_ATTRIB_FLOAT = 0,
+    VERTEX_ATTRIB_SHORT = 1,
+    VERTEX_ATTRIB_HALF = 2,
+    VERTEX_ATTRIB_INT_2_10_10_10 = 3,
+};
+
+struct VertexAttrib
+{
+    VertexAttribType type = VERTEX_ATTRIB_FLOAT;
+    int components = 0;
+    size_t offset = 0;
+};
+
+struct PackedVertices
+{
+    std::vector<uint8_t> bytes;
+    size_t stride = 0;
+    VertexAttrib position, normal, uv;
+    PositionDecode decode;
+};
+
+// Interleave verts in format. bounds must contain every vertex (the mesh's LocalBox).
+void PackVertices(const std::vector<SimpleVertex> &verts, const LocalBox &bounds, const VertexFormat &format,
+                  PackedVertices &out);
+
+// Index buffer, 16-bit when the format allows it and vertexCount fits
+struct PackedIndices
+{
+    std::vector<uint8_t> bytes;
+    bool shortIndices = false;
+};
+void PackIndices(const std::vector<unsigned int> &inds, size_t vertexCount, const VertexFormat &format,
+                 PackedIndices &out);
+
+// ===== Position-only stream (depth passes) =====
+
+// Tightly packed float positions (12 bytes per vertex)
+void PackPositions(const std::vector<SimpleVertex> &verts, std::vector<glm::vec3> &out);
+
+// Positions as 16-bit integers relative to bounds (which must contain every vertex), four per
+// vertex with w = 0 so vertices stay 8-byte aligned. Error is at most half a step, bounds.half / 32767.
+PositionDecode QuantizePositions(const std::vector<SimpleVertex> &verts, const LocalBox &bounds,
+                                 std::vector<int16_t> &out);
+
+// ===== Scalar codecs (the shaders' decode, mirrored for checks) =====
+
+uint32_t EncodeOctahedral(const glm::vec3 &n);
+glm::vec3 DecodeOctahedral(uint32_t packed);
+uint32_t EncodeInt2_10_10_10(const glm::vec3 &n);
+glm::vec3 DecodeInt2_10_10_10(uint32_t packed);
+uint16_t FloatToHalf(float f);
+float HalfToFloat(uint16_t h);
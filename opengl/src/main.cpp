@@ -24,6 +24,10 @@
 #include "UI.h"
 #include "Game.h"
 #include "Audio.h"
+#include "GameRenderer.h"
+#include "Replay.h"
+#include "Paths.h"
+#include <cstring>
 const int WINW = 1280, WINH = 920;
 bool keys[1024] = {0};
 bool mousePressed = false;
@@ -44,6 +48,8 @@ static glm::vec3 camVel = glm::vec3(0.0f);
 glm::vec3 lightPos = glm::vec3(3.0f, 6.0f, 3.0f);
 bool firstPerson = false;
 int lastV = GLFW_RELEASE;
+bool showStats = false; // F3: renderer counters under the timer
+int lastF3 = GLFW_RELEASE;
 enum class State
 {
     MENU,
@@ -59,43 +65,23 @@ void mouse_cb(GLFWwindow *w, int button, int action, int mods);
 void firstPersonInit();
 void thirdPersonInit();
 
-std::string GetExecutableDir()
+int main(int argc, char **argv)
 {
-#ifdef _WIN32
-    // Windows platform
-    char path[MAX_PATH];
-    GetModuleFileNameA(NULL, path, MAX_PATH);
-    std::string full(path);
-    size_t pos = full.find_last_of("\\/");
-    return full.substr(0, pos);
-#elif __APPLE__
-    // macOS platform
-    char path[1024];
-    uint32_t size = sizeof(path);
-    _NSGetExecutablePath(path, &size);
-
-    char resolved[1024];
-    realpath(path, resolved);
-
-    std::string full(resolved);
-    size_t pos = full.find_last_of("/");
-    return full.substr(0, pos);
-#else
-    // Linux platform
-    char path[PATH_MAX];
-    ssize_t count = readlink("/proc/self/exe", path, PATH_MAX);
-    if (count != -1)
+    // --record <file>: save seed + per-frame input of the first run (replay it with HelloGLSim)
+    // --shadow-quality low|medium|high|ultra: shadow filter taps (1, 4, 8 or 16)
+    // --vertex-format full|octahedral|1010102: uploaded vertex layout (default octahedral)
+    std::string recordPath;
+    ShadowQuality shadowQuality = SHADOW_QUALITY_MEDIUM;
+    VertexFormat vertexFormat;
+    for (int i = 1; i + 1 < argc; ++i)
     {
-        std::string full(path);
-        size_t pos = full.find_last_of("/");
-        return full.substr(0, pos);
+        if (std::strcmp(argv[i], "--record") == 0)
+            recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--shadow-quality") == 0 && !ShadowQualityFromName(argv[++i], shadowQuality))
+            std::cerr << "unknown shadow quality " << argv[i] << ", ignored\n";
+        else if (std::strcmp(argv[i], "--vertex-format") == 0 && !VertexFormatFromName(argv[++i], vertexFormat))
+            std::cerr << "unknown vertex format " << argv[i] << ", ignored\n";
     }
-    return ".";
-#endif
-}
-
-int main()
-{
 
     glfwInit();
     if (!glfwInit())
@@ -137,7 +123,8 @@ int main()
     audio.PlaySound(dropBuffer, true); // loop background sound
     Shader shader3D(
         (base + "/shaders/phong.vs").c_str(),
-        (base + "/shaders/phong.fs").c_str());
+        (base + "/shaders/phong.fs").c_str(),
+        ShadowQualityDefines(shadowQuality) + VertexFormatDefines(vertexFormat));
     Shader shadowShader((base + "/shaders/shadow_depth.vs").c_str(), (base + "/shaders/shadow_depth.fs").c_str());
 
     Shader shaderText((base + "/shaders/text.vs").c_str(), (base + "/shaders/text.fs").c_str());
@@ -145,13 +132,19 @@ int main()
     ui.Init((base + "/assets/fonts/Roboto-Regular.ttf").c_str(), 48); // ensure assets/Roboto-Regular.ttf exists relative to build dir
     Game game;
     game.LoadResources(base + "/assets");
-    game.shadowShader = shadowShader.ID;
     game.Reset();
-    game.InitShadowMap();
     // Load walk_cat.obj model file
     std::string modelPath = base + "/assets/models/walk_cat.obj";
     game.LoadPlayerModel(modelPath.c_str());
     game.playerModel.modelScale = glm::vec3(0.5f);
+
+    GameRenderer renderer;
+    renderer.vertexFormat = vertexFormat;
+    renderer.Init(game);
+    renderer.shadowShader = &shadowShader;
+    renderer.InitShadowMap();
+    ReplayRecorder recorder;
+    bool recordedRun = false;
     std::vector<float> data;
 
     float cubeVerts[] = {
@@ -183,7 +176,7 @@ int main()
     glBindVertexArray(VAO); // keep bound for draw calls later (we'll not unbind)
     // To make it accessible, set to 1 (not ideal), but we'll use VAO 1 implicitly
     // after creating VAO (variable name VAO)
-    game.SetCubeVAO(VAO);
+    renderer.SetCubeVAO(VAO);
     // Create Text renderer and UI
 
     auto last = std::chrono::high_resolution_clock::now();
@@ -206,6 +199,13 @@ int main()
         }
         if (!keys[GLFW_KEY_V])
             lastV = GLFW_RELEASE;
+        if (keys[GLFW_KEY_F3] && lastF3 == GLFW_RELEASE)
+        {
+            showStats = !showStats;
+            lastF3 = GLFW_PRESS;
+        }
+        if (!keys[GLFW_KEY_F3])
+            lastF3 = GLFW_RELEASE;
         if (keys[GLFW_KEY_ESCAPE])
             glfwSetWindowShouldClose(win, true);
 
@@ -229,6 +229,8 @@ int main()
             {
                 state = State::PLAYING;
                 game.Reset();
+                if (!recordPath.empty() && !recordedRun)
+                    recordedRun = recorder.Begin(recordPath, game);
             }
             if (uiAction == 2)
             {
@@ -241,6 +243,8 @@ int main()
             {
                 state = State::PLAYING;
                 game.Reset();
+                if (!recordPath.empty() && !recordedRun)
+                    recordedRun = recorder.Begin(recordPath, game);
             }
             if (uiAction == 2)
             {
@@ -249,9 +253,13 @@ int main()
         }
         else if (state == State::PLAYING)
         {
-            game.Update(dt, keys, cameraFront, cameraUp);
+            game.Advance(dt, keys, cameraFront, cameraUp);
+            recorder.RecordFrame(dt, keys, cameraFront, cameraUp, game);
             if (game.playerDead)
+            {
                 state = State::GAMEOVER;
+                recorder.End();
+            }
         }
         int W, H;
         glfwGetFramebufferSize(win, &W, &H);
@@ -263,9 +271,10 @@ int main()
         glm::mat4 proj = glm::perspective(glm::radians(aspect), (float)W / H, 0.1f, 100.0f);
         glm::mat4 view;
         glm::vec3 cameraPos;
+        glm::vec3 playerPos = game.RenderPlayerPos();
         if (firstPerson)
         {
-            cameraPos = game.player.pos + glm::vec3(0.0f, 0.6f, -0.6f);
+            cameraPos = playerPos + glm::vec3(0.0f, 0.6f, -0.6f);
             view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
         }
         else
@@ -273,25 +282,23 @@ int main()
             glm::vec3 offset = glm::vec3(0.0f, 4.0f, 14.0f);
 
             // smooth follow (lerp)
-            glm::vec3 desiredPos = game.player.pos + offset;
+            glm::vec3 desiredPos = playerPos + offset;
             float followSpeed = 6.0f;
             float t = glm::clamp(followSpeed * dt, 0.0f, 1.0f);
             smoothCamPos = glm::mix(smoothCamPos, desiredPos, t);
 
             // look at slightly above player center
-            glm::vec3 camTarget = game.player.pos + glm::vec3(0.0f, 0.6f, 0.0f);
+            glm::vec3 camTarget = playerPos + glm::vec3(0.0f, 0.6f, 0.0f);
             cameraPos = smoothCamPos;
             view = glm::lookAt(smoothCamPos, camTarget, glm::vec3(0, 1, 0));
         }
         if (state == State::PLAYING)
         {
             glBindVertexArray(VAO);
-            shader3D.use();
-            shader3D.setMat4("uView", view);
-            shader3D.setMat4("uProj", proj);
 
-            // now render the game (Game::Render should bind VAO and use shader uniforms)
-            game.Render(shader3D.ID, cameraPos);
+            // now render the game (GameRenderer::Render binds VAOs, fills the per-frame
+            // uniform buffers and sets the per-draw uniforms)
+            renderer.Render(game, shader3D, view, proj, cameraPos);
 
             glBindVertexArray(0);
         }
@@ -322,10 +329,25 @@ int main()
             char buf[64];
             snprintf(buf, sizeof(buf), "Time: %.2f s", survivalTime);
             ui.text.RenderText(buf, -0.98f, 0.9f, 0.8f, glm::vec3(0.95f), winW, winH, shaderText.ID);
+            if (showStats)
+            {
+                const DrawListStats &draws = renderer.DrawStats();
+                const CullStats &mainCull = renderer.MainCullStats();
+                const CullStats &shadowCull = renderer.ShadowCullStats();
+                char stats[160];
+                snprintf(stats, sizeof(stats), "draws %u  state changes %u (saved %u)", draws.items,
+                         draws.stateChanges, draws.Saved());
+                ui.text.RenderText(stats, -0.98f, 0.82f, 0.5f, glm::vec3(0.8f), winW, winH, shaderText.ID);
+                snprintf(stats, sizeof(stats), "culled main %u/%u  shadow %u/%u  static shadow rebuilds %u",
+                         mainCull.culled, mainCull.tested, shadowCull.culled, shadowCull.tested,
+                         renderer.StaticShadowRebuilds());
+                ui.text.RenderText(stats, -0.98f, 0.77f, 0.5f, glm::vec3(0.8f), winW, winH, shaderText.ID);
+            }
         }
 
         glfwSwapBuffers(win);
     }
+    recorder.End();
     audio.Shutdown();
     glfwTerminate();
     return 0;